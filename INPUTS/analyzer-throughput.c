@@ -0,0 +1,91 @@
+// A fixed set of functions for measuring path-sensitive analyzer throughput:
+// branches on symbolic values, loops, pointer and struct bindings, and calls
+// whose results are invalidated.  Divide the exploded node count reported by
+//   clang -cc1 -analyze -analyzer-checker=core,deadcode,unix -print-stats \
+//     INPUTS/analyzer-throughput.c
+// by the time the same command takes to get nodes per second.
+
+typedef __typeof(sizeof(int)) size_t;
+void *malloc(size_t);
+
+struct point { int x, y; };
+struct list { struct list *next; struct point p; int tag; };
+
+int opaque(int);
+void consume(void *);
+
+int branches(int a, int b, int c, int d) {
+  int r = 0;
+  if (a > 0) r += 1; else r -= 1;
+  if (b > a) r += 2; else r -= 2;
+  if (c == b) r += 3; else r -= 3;
+  if (d < c) r += 4; else r -= 4;
+  if (a + b > c) r *= 2;
+  if (r > 10 && d != 0) r /= d;
+  return r;
+}
+
+int loops(int n, int *buf) {
+  int sum = 0, i, j;
+  for (i = 0; i < n && i < 16; ++i)
+    for (j = 0; j < 4; ++j)
+      if (buf[i] > j)
+        sum += buf[i] - j;
+      else
+        sum -= opaque(j);
+  return sum;
+}
+
+struct point fields(struct point *p, int k) {
+  struct point q = *p;
+  if (k) {
+    q.x = p->y;
+    q.y = opaque(q.x);
+  } else {
+    q.x = q.y + k;
+  }
+  if (q.x == q.y)
+    p->x = 0;
+  return q;
+}
+
+struct list *build(int n) {
+  struct list *head = 0;
+  int i;
+  for (i = 0; i < n && i < 8; ++i) {
+    struct list *l = malloc(sizeof(*l));
+    if (!l)
+      break;
+    l->next = head;
+    l->p.x = i;
+    l->p.y = opaque(i);
+    l->tag = l->p.y > i;
+    head = l;
+  }
+  return head;
+}
+
+int walk(struct list *l) {
+  int count = 0;
+  while (l) {
+    if (l->tag)
+      count += l->p.x;
+    else
+      consume(l);
+    l = l->next;
+  }
+  return count;
+}
+
+int state_machine(const int *in, int n) {
+  int state = 0, i;
+  for (i = 0; i < n && i < 12; ++i) {
+    switch (state) {
+    case 0: state = in[i] ? 1 : 2; break;
+    case 1: state = in[i] > 3 ? 3 : 0; break;
+    case 2: state = opaque(in[i]) ? 3 : 1; break;
+    case 3: if (in[i] == 7) return i; state = 0; break;
+    }
+  }
+  return -1;
+}
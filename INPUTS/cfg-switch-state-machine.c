@@ -0,0 +1,32 @@
+// A generated-looking state machine: one function with a large switch whose
+// cases each branch on the input and jump to other states, so that the CFG
+// has many blocks with many predecessors and successors.  Time CFG
+// construction and look at the CFG memory statistics with:
+//   clang -cc1 -fsyntax-only -Wuninitialized -Wunreachable-code -print-stats \
+//     INPUTS/cfg-switch-state-machine.c
+
+#define STATE(n) \
+  case n: \
+    if (in[i] == (n) % 7) { state = ((n) * 5 + 1) % 1024; break; } \
+    if (in[i] > (n) % 11) { acc += n; goto next; } \
+    state = ((n) * 3 + 2) % 1024; \
+    break;
+
+#define STATE4(n) STATE(n##0) STATE(n##1) STATE(n##2) STATE(n##3)
+#define STATE16(n) STATE4(n##0) STATE4(n##1) STATE4(n##2) STATE4(n##3)
+#define STATE64(n) STATE16(n##0) STATE16(n##1) STATE16(n##2) STATE16(n##3)
+#define STATE256(n) STATE64(n##0) STATE64(n##1) STATE64(n##2) STATE64(n##3)
+
+int run(const int *in, int n) {
+  int state = 0, acc = 0, i;
+  for (i = 0; i < n; ++i) {
+    switch (state) {
+    STATE256(1) STATE256(2) STATE256(3)
+    default:
+      return -1;
+    }
+  next:
+    ;
+  }
+  return acc;
+}
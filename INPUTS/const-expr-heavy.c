@@ -0,0 +1,36 @@
+// Stresses integer constant expression evaluation: array bounds, enumerator
+// values and case labels built from long chains of arithmetic, shifts,
+// comparisons and conditionals.  Compare the evaluators with:
+//   clang -cc1 -fsyntax-only -fconstant-evaluator=tree INPUTS/const-expr-heavy.c
+//   clang -cc1 -fsyntax-only -fconstant-evaluator=bytecode INPUTS/const-expr-heavy.c
+
+#define T0(x) (((x) * 3 + 1) % 17 ^ ((x) << 2 >> 1) | (5 > 3 ? 8 : 4))
+#define T1(x) T0(T0(x) & 0xff)
+#define T2(x) T1(T1(x) & 0xff)
+#define T3(x) T2(T2(x) & 0xff)
+#define T4(x) T3((x) && (x) != 3 ? T3(x) & 0xff : !(x))
+
+#define E(n) e##n = T4(n) & 0x7f,
+#define E4(n) E(n##0) E(n##1) E(n##2) E(n##3)
+#define E16(n) E4(n##0) E4(n##1) E4(n##2) E4(n##3)
+#define E64(n) E16(n##0) E16(n##1) E16(n##2) E16(n##3)
+
+enum Values { E64(1) E64(2) E64(3) E64(4) last };
+
+#define A(n) char a##n[(T4(n) & 0x3f) + 1];
+#define A4(n) A(n##0) A(n##1) A(n##2) A(n##3)
+#define A16(n) A4(n##0) A4(n##1) A4(n##2) A4(n##3)
+#define A64(n) A16(n##0) A16(n##1) A16(n##2) A16(n##3)
+
+struct Arrays { A64(1) A64(2) A64(3) A64(4) };
+
+#define C(n) case (T4(n) & 0xff) + (n) * 256: return n;
+#define C4(n) C(n##0) C(n##1) C(n##2) C(n##3)
+#define C16(n) C4(n##0) C4(n##1) C4(n##2) C4(n##3)
+
+int lookup(int v) {
+  switch (v) {
+  C16(1) C16(2) C16(3) C16(4)
+  }
+  return -1;
+}
@@ -0,0 +1,43 @@
+// Declares thousands of names in one namespace in the style of
+// protobuf-generated headers: a forward declaration and a definition for each
+// message class, plus free functions that are overloaded for every message
+// type and declared twice, once up front and once next to the definition.
+
+namespace proto {
+namespace generated {
+
+#define FWD_MESSAGE(N) \
+  class Message##N; \
+  void Swap(Message##N &, Message##N &); \
+  bool operator==(const Message##N &, const Message##N &); \
+  template<typename T> T *Clone(const Message##N &, T *);
+
+#define DEF_MESSAGE(N) \
+  class Message##N { \
+  public: \
+    int id() const { return id_; } \
+    void set_id(int value) { id_ = value; } \
+    bool has_id() const { return id_ != 0; } \
+    void clear_id() { id_ = 0; } \
+  private: \
+    int id_; \
+  }; \
+  void Swap(Message##N &a, Message##N &b) { \
+    Message##N t = a; a = b; b = t; \
+  } \
+  bool operator==(const Message##N &a, const Message##N &b) { \
+    return a.id() == b.id(); \
+  } \
+  template<typename T> T *Clone(const Message##N &, T *p) { return p; }
+
+#define X4(M, N) M(N##0) M(N##1) M(N##2) M(N##3)
+#define X16(M, N) X4(M, N##0) X4(M, N##1) X4(M, N##2) X4(M, N##3)
+#define X64(M, N) X16(M, N##0) X16(M, N##1) X16(M, N##2) X16(M, N##3)
+#define X256(M, N) X64(M, N##0) X64(M, N##1) X64(M, N##2) X64(M, N##3)
+#define X1024(M) X256(M, 0) X256(M, 1) X256(M, 2) X256(M, 3)
+
+X1024(FWD_MESSAGE)
+X1024(DEF_MESSAGE)
+
+} // end namespace generated
+} // end namespace proto
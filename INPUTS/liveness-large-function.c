@@ -0,0 +1,29 @@
+// A single function with thousands of statements and hundreds of local
+// variables, most of them live across loops, for timing the live variables
+// analysis. Compare the set representations with:
+//   clang -cc1 -analyze -analyzer-checker=deadcode.DeadStores -analyzer-liveness=sparse INPUTS/liveness-large-function.c
+//   clang -cc1 -analyze -analyzer-checker=deadcode.DeadStores -analyzer-liveness=dense INPUTS/liveness-large-function.c
+
+int input(int);
+
+#define DECL(n) int v##n = input(n);
+#define DECL4(n) DECL(n##0) DECL(n##1) DECL(n##2) DECL(n##3)
+#define DECL16(n) DECL4(n##0) DECL4(n##1) DECL4(n##2) DECL4(n##3)
+#define DECL64(n) DECL16(n##0) DECL16(n##1) DECL16(n##2) DECL16(n##3)
+
+#define STEP(n) if (v##n & 1) v##n = v##n * 3 + 1; else v##n /= 2; sum += v##n;
+#define STEP4(n) STEP(n##0) STEP(n##1) STEP(n##2) STEP(n##3)
+#define STEP16(n) STEP4(n##0) STEP4(n##1) STEP4(n##2) STEP4(n##3)
+#define STEP64(n) STEP16(n##0) STEP16(n##1) STEP16(n##2) STEP16(n##3)
+
+int f(int iterations) {
+  int sum = 0;
+  DECL64(1) DECL64(2) DECL64(3) DECL64(4)
+  for (int i = 0; i < iterations; ++i) {
+    STEP64(1) STEP64(2)
+    if (sum > iterations)
+      continue;
+    STEP64(3) STEP64(4)
+  }
+  return sum;
+}
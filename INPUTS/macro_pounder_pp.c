@@ -0,0 +1,37 @@
+// This pounds on macro expansion in the style of Boost.Preprocessor: deep
+// function-like expansion with repeated and pre-expanded arguments, token
+// pasting through helper macros, and chains of object-like macro aliases.
+
+// Object-like alias chains.
+#define VAL_0 42
+#define VAL_1 VAL_0
+#define VAL_2 VAL_1
+#define VAL_3 VAL_2
+#define VAL_4 VAL_3
+
+// Concatenation that forces pre-expansion of its arguments.
+#define PP_CAT(A, B) PP_CAT_I(A, B)
+#define PP_CAT_I(A, B) A ## B
+
+// Arguments that are used several times in the replacement list.
+#define PP_SQR(X) ((X) * (X))
+#define PP_MAX(A, B) ((A) > (B) ? (A) : (B))
+
+#define PP_ELEM(N, D) PP_MAX(PP_SQR(VAL_4), PP_SQR(PP_CAT(N, D))) +
+
+#define PP_REPEAT_1(M, D) M(1, D)
+#define PP_REPEAT_2(M, D) PP_REPEAT_1(M, D) M(2, D)
+#define PP_REPEAT_4(M, D) PP_REPEAT_2(M, D) PP_REPEAT_2(M, D)
+#define PP_REPEAT_8(M, D) PP_REPEAT_4(M, D) PP_REPEAT_4(M, D)
+#define PP_REPEAT_16(M, D) PP_REPEAT_8(M, D) PP_REPEAT_8(M, D)
+#define PP_REPEAT_32(M, D) PP_REPEAT_16(M, D) PP_REPEAT_16(M, D)
+#define PP_REPEAT_64(M, D) PP_REPEAT_32(M, D) PP_REPEAT_32(M, D)
+#define PP_REPEAT_128(M, D) PP_REPEAT_64(M, D) PP_REPEAT_64(M, D)
+#define PP_REPEAT_256(M, D) PP_REPEAT_128(M, D) PP_REPEAT_128(M, D)
+
+#define B0 PP_REPEAT_256(PP_ELEM, 0)
+#define B1 B0 B0 B0 B0 B0 B0 B0 B0
+#define B2 B1 B1 B1 B1 B1 B1 B1 B1
+#define B3 B2 B2 B2 B2 B2 B2 B2 B2
+
+B3 0
@@ -0,0 +1,48 @@
+// Mangles many members of class template specializations nested in several
+// namespaces, so that every mangled name repeats a long prefix.  Time it
+// with:
+//   clang -cc1 -emit-llvm-only INPUTS/mangle-nested-templates.cpp
+
+namespace company { namespace product { namespace component {
+namespace detail { namespace v1 {
+
+template<typename T, typename U, int N> struct Container {
+  struct Iterator {
+    T *get() const { return 0; }
+    void advance(U) {}
+  };
+
+  void push(const T &) {}
+  void pop() {}
+  T &front() { static T t; return t; }
+  U size(U) const { return U(); }
+  Iterator begin() { return Iterator(); }
+  template<typename V> V convert(const V &v) { return v; }
+};
+
+} } } } }
+
+using namespace company::product::component::detail::v1;
+
+struct Key {};
+struct Value {};
+
+#define USE(T, U, N) \
+  void use_##N() { \
+    Container<T, U, N> c; \
+    c.push(T()); \
+    c.pop(); \
+    c.front(); \
+    c.size(U()); \
+    c.begin().get(); \
+    c.begin().advance(U()); \
+    c.convert(1); \
+    c.convert(1.0); \
+  }
+
+#define USE4(N) USE(Key, int, N##0) USE(Value, long, N##1) \
+                USE(Key, short, N##2) USE(Value, char, N##3)
+#define USE16(N) USE4(N##0) USE4(N##1) USE4(N##2) USE4(N##3)
+#define USE64(N) USE16(N##0) USE16(N##1) USE16(N##2) USE16(N##3)
+
+USE64(1) USE64(2) USE64(3) USE64(4)
@@ -0,0 +1,41 @@
+// Keeps many structs and arrays bound in the store at once and passes one of
+// them at a time to an opaque call, so that every call invalidates a single
+// cluster of a large store.  Compare exploded nodes per second, as described
+// in INPUTS/analyzer-throughput.c, for:
+//   clang -cc1 -analyze -analyzer-checker=core,deadcode -print-stats \
+//     INPUTS/region-store-clusters.c
+
+struct rec { int a, b, c, d; int buf[4]; };
+
+void touch(struct rec *);
+int opaque(int);
+
+#define DECL(n) struct rec r##n = { n, n + 1, n + 2, n + 3, { n } };
+#define DECL4(n) DECL(n##0) DECL(n##1) DECL(n##2) DECL(n##3)
+#define DECL16(n) DECL4(n##0) DECL4(n##1) DECL4(n##2) DECL4(n##3)
+
+#define USE(n) \
+  touch(&r##n); \
+  sum += r##n.buf[n % 4] - r##n.b + opaque(n);
+#define USE4(n) USE(n##0) USE(n##1) USE(n##2) USE(n##3)
+#define USE16(n) USE4(n##0) USE4(n##1) USE4(n##2) USE4(n##3)
+
+int many_records(void) {
+  int sum = 0;
+  DECL16(1) DECL16(2)
+  USE16(1) USE16(2)
+  return sum;
+}
+
+struct rec g0, g1, g2, g3;
+
+int globals_and_locals(int n) {
+  int sum = 0, i;
+  DECL16(3)
+  for (i = 0; i < n && i < 4; ++i) {
+    touch(&g0);
+    sum += g1.a + g2.b + g3.c;
+    USE4(30) USE4(31)
+  }
+  return sum;
+}
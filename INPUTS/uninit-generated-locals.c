@@ -0,0 +1,27 @@
+// Generated-looking code: one function with thousands of locals initialized
+// at their declaration and hundreds of branches, plus a few variables that
+// really are assigned conditionally.  Time -Wuninitialized on it with:
+//   clang -cc1 -fsyntax-only -Wuninitialized -Wconditional-uninitialized \
+//     -print-stats INPUTS/uninit-generated-locals.c
+
+int sink(int);
+
+#define STEP(n) \
+  int v##n = sink(n); \
+  if (v##n > (n) % 13) \
+    acc += v##n; \
+  else \
+    flag = v##n;
+
+#define STEP4(n) STEP(n##0) STEP(n##1) STEP(n##2) STEP(n##3)
+#define STEP16(n) STEP4(n##0) STEP4(n##1) STEP4(n##2) STEP4(n##3)
+#define STEP64(n) STEP16(n##0) STEP16(n##1) STEP16(n##2) STEP16(n##3)
+#define STEP256(n) STEP64(n##0) STEP64(n##1) STEP64(n##2) STEP64(n##3)
+
+int generated(int n) {
+  int acc = 0;
+  int flag;
+  STEP256(1) STEP256(2) STEP256(3) STEP256(4)
+  STEP256(5) STEP256(6) STEP256(7) STEP256(8)
+  return acc + flag + n;
+}
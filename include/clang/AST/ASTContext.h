@@ -384,6 +384,63 @@ public:
   }
   /// Return the total memory used for various side tables.
   size_t getSideTableAllocatedMemory() const;
+
+  /// \brief The result of successfully constant folding an expression, as
+  /// remembered by Expr::Evaluate when LangOptions::ConstantEvaluationCache
+  /// is enabled.
+  struct CachedEvaluation {
+    APValue Val;
+    bool HasSideEffects;
+    unsigned Diag;
+    const Expr *DiagExpr;
+    SourceLocation DiagLoc;
+  };
+
+  /// \brief Whether Expr::Evaluate may remember and reuse its results.
+  ///
+  /// Sema rewrites expressions in place while it builds them (e.g. by
+  /// wrapping operands in implicit casts), so results are only cached for
+  /// declarations that Sema has finished, i.e. while the AST consumer is
+  /// processing them.
+  bool canCacheEvaluations() const {
+    return LangOpts.ConstantEvaluationCache && CanCacheEvaluations;
+  }
+
+  /// \brief Whether the expressions being evaluated are no longer rewritten
+  /// by Sema, so that what is derived from them may be kept.
+  bool areEvaluatedExprsFinished() const { return CanCacheEvaluations; }
+
+  /// \brief Set whether the expressions being evaluated are no longer
+  /// rewritten by Sema; see canCacheEvaluations.
+  void setCanCacheEvaluations(bool Value) { CanCacheEvaluations = Value; }
+
+  /// \brief Retrieve the remembered result of constant folding \p E, or
+  /// null if it was not folded before.
+  const CachedEvaluation *getCachedEvaluation(const Expr *E) const {
+    llvm::DenseMap<const Expr *, CachedEvaluation>::const_iterator Pos
+      = CachedEvaluations.find(E);
+    if (Pos == CachedEvaluations.end())
+      return 0;
+    return &Pos->second;
+  }
+
+  /// \brief Remember the result of constant folding \p E.
+  void setCachedEvaluation(const Expr *E, const CachedEvaluation &Result) const {
+    CachedEvaluations[E] = Result;
+  }
+
+  /// \brief Note that a result from getCachedEvaluation was used instead of
+  /// evaluating the expression again.
+  void noteCachedEvaluationReused() const { ++NumCachedEvaluationsReused; }
+
+  /// \brief Retrieve the data the constant evaluator keeps for this context,
+  /// or null. It is owned and interpreted by the evaluator.
+  void *getConstantEvaluatorCache() const { return ConstantEvaluatorCache; }
+
+  /// \brief Set the data the constant evaluator keeps for this context.
+  void setConstantEvaluatorCache(void *Cache) const {
+    ConstantEvaluatorCache = Cache;
+  }
   
   PartialDiagnostic::StorageAllocator &getDiagAllocator() {
     return DiagAllocator;
@@ -1758,6 +1815,18 @@ private:
 
   /// \brief A counter used to uniquely identify "blocks".
   mutable unsigned int UniqueBlockByRefTypeID;
+
+  /// \brief Results of constant folding, keyed by the folded expression.
+  mutable llvm::DenseMap<const Expr *, CachedEvaluation> CachedEvaluations;
+
+  /// \brief The number of constant foldings answered from CachedEvaluations.
+  mutable unsigned NumCachedEvaluationsReused;
+
+  /// \brief Whether CachedEvaluations may be used; see canCacheEvaluations.
+  bool CanCacheEvaluations;
+
+  /// \brief See getConstantEvaluatorCache.
+  mutable void *ConstantEvaluatorCache;
   
   friend class DeclContext;
   friend class DeclarationNameTable;
@@ -179,6 +179,15 @@ public:
   /// overloaded function.
   bool declarationReplaces(NamedDecl *OldD) const;
 
+  /// \brief Determine whether the only declaration that this declaration
+  /// can replace (per declarationReplaces) is its own previous declaration,
+  /// as is the case for functions and function templates. If so, \p Prev
+  /// is set to that previous declaration, or null if there is none.
+  ///
+  /// This lets callers that hold many overloads of the same name find the
+  /// replaced declaration without testing each of them.
+  bool replacesOnlyPreviousDeclaration(NamedDecl *&Prev) const;
+
   /// \brief Determine whether this declaration has linkage.
   bool hasLinkage() const;
 
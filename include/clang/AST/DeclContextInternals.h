@@ -20,6 +20,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Capacity.h"
 #include <algorithm>
 
 namespace clang {
@@ -30,33 +31,55 @@ class DependentDiagnostic;
 /// containing one entry.
 struct StoredDeclsList {
 
-  /// DeclsTy - When in vector form, this is what the Data pointer points to.
+  /// DeclsTy - The declarations of a list in vector form.
   typedef SmallVector<NamedDecl *, 4> DeclsTy;
 
+  /// IndexTy - Maps each declaration of a long list to its position.
+  typedef llvm::DenseMap<NamedDecl *, unsigned> IndexTy;
+
+  /// IndexThreshold - The length from which a list keeps an index, so that
+  /// redeclaring one of many overloads doesn't scan all of them.
+  static const unsigned IndexThreshold = 16;
+
+private:
+  /// VectorTy - When in vector form, this is what the Data pointer points to.
+  struct VectorTy {
+    DeclsTy Decls;
+
+    /// Index - The position of each declaration in Decls, or null if the
+    /// list is too short to need one or the positions changed since it was
+    /// built.
+    IndexTy *Index;
+
+    VectorTy() : Index(0) {}
+    VectorTy(const VectorTy &RHS) : Decls(RHS.Decls), Index(0) {}
+    ~VectorTy() { delete Index; }
+  };
+
   /// \brief The stored data, which will be either a pointer to a NamedDecl,
   /// or a pointer to a vector.
-  llvm::PointerUnion<NamedDecl *, DeclsTy *> Data;
+  llvm::PointerUnion<NamedDecl *, VectorTy *> Data;
 
 public:
   StoredDeclsList() {}
 
   StoredDeclsList(const StoredDeclsList &RHS) : Data(RHS.Data) {
-    if (DeclsTy *RHSVec = RHS.getAsVector())
-      Data = new DeclsTy(*RHSVec);
+    if (VectorTy *RHSVec = RHS.Data.dyn_cast<VectorTy *>())
+      Data = new VectorTy(*RHSVec);
   }
 
   ~StoredDeclsList() {
     // If this is a vector-form, free the vector.
-    if (DeclsTy *Vector = getAsVector())
+    if (VectorTy *Vector = Data.dyn_cast<VectorTy *>())
       delete Vector;
   }
 
   StoredDeclsList &operator=(const StoredDeclsList &RHS) {
-    if (DeclsTy *Vector = getAsVector())
+    if (VectorTy *Vector = Data.dyn_cast<VectorTy *>())
       delete Vector;
     Data = RHS.Data;
-    if (DeclsTy *RHSVec = RHS.getAsVector())
-      Data = new DeclsTy(*RHSVec);
+    if (VectorTy *RHSVec = RHS.Data.dyn_cast<VectorTy *>())
+      Data = new VectorTy(*RHSVec);
     return *this;
   }
 
@@ -67,7 +90,21 @@ public:
   }
 
   DeclsTy *getAsVector() const {
-    return Data.dyn_cast<DeclsTy *>();
+    if (VectorTy *Vector = Data.dyn_cast<VectorTy *>())
+      return &Vector->Decls;
+    return 0;
+  }
+
+  /// getVectorMemorySize - Return the memory used by the vector form of
+  /// this list, including its index.
+  size_t getVectorMemorySize() const {
+    VectorTy *Vector = Data.dyn_cast<VectorTy *>();
+    if (!Vector)
+      return 0;
+    size_t Size = sizeof(*Vector) + llvm::capacity_in_bytes(Vector->Decls);
+    if (Vector->Index)
+      Size += sizeof(*Vector->Index) + Vector->Index->getMemorySize();
+    return Size;
   }
 
   void setOnlyValue(NamedDecl *ND) {
@@ -92,6 +129,7 @@ public:
     DeclsTy::iterator I = std::find(Vec.begin(), Vec.end(), D);
     assert(I != Vec.end() && "list does not contain decl");
     Vec.erase(I);
+    invalidateIndex();
 
     assert(std::find(Vec.begin(), Vec.end(), D)
              == Vec.end() && "list still contains decl");
@@ -133,11 +171,21 @@ public:
 
     // Determine if this declaration is actually a redeclaration.
     DeclsTy &Vec = *getAsVector();
-    for (DeclsTy::iterator OD = Vec.begin(), ODEnd = Vec.end();
-         OD != ODEnd; ++OD) {
-      NamedDecl *OldD = *OD;
-      if (D->declarationReplaces(OldD)) {
-        *OD = D;
+
+    // Functions can only replace their previous declaration, which saves
+    // testing each of what may be a great many overloads.
+    NamedDecl *PrevD;
+    if (D->replacesOnlyPreviousDeclaration(PrevD)) {
+      unsigned Pos;
+      if (!PrevD || !findDecl(PrevD, Pos))
+        return false;
+      replaceDecl(Pos, D);
+      return true;
+    }
+
+    for (unsigned Pos = 0, N = Vec.size(); Pos != N; ++Pos) {
+      if (D->declarationReplaces(Vec[Pos])) {
+        replaceDecl(Pos, D);
         return true;
       }
     }
@@ -152,8 +200,8 @@ public:
     // If this is the second decl added to the list, convert this to vector
     // form.
     if (NamedDecl *OldD = getAsDecl()) {
-      DeclsTy *VT = new DeclsTy();
-      VT->push_back(OldD);
+      VectorTy *VT = new VectorTy();
+      VT->Decls.push_back(OldD);
       Data = VT;
     }
 
@@ -168,7 +216,7 @@ public:
     // iterator which points at the first tag will start a span of
     // decls that only contains tags.
     if (D->hasTagIdentifierNamespace())
-      Vec.push_back(D);
+      appendDecl(D);
 
     // Resolved using declarations go at the front of the list so that
     // they won't show up in other lookup results.  Unresolved using
@@ -182,16 +230,67 @@ public:
           ++I;
       }
       Vec.insert(I, D);
+      invalidateIndex();
 
     // All other declarations go at the end of the list, but before any
     // tag declarations.  But we can be clever about tag declarations
     // because there can only ever be one in a scope.
     } else if (Vec.back()->hasTagIdentifierNamespace()) {
       NamedDecl *TagD = Vec.back();
-      Vec.back() = D;
-      Vec.push_back(TagD);
+      replaceDecl(Vec.size() - 1, D);
+      appendDecl(TagD);
     } else
-      Vec.push_back(D);
+      appendDecl(D);
+  }
+
+private:
+  /// findDecl - Find the position of \p D in the vector form of this list,
+  /// using (and if needed, building) the index once the list is long.
+  bool findDecl(NamedDecl *D, unsigned &Pos) {
+    VectorTy &Vector = *Data.get<VectorTy *>();
+    DeclsTy &Vec = Vector.Decls;
+    if (Vec.size() < IndexThreshold) {
+      DeclsTy::iterator I = std::find(Vec.begin(), Vec.end(), D);
+      Pos = I - Vec.begin();
+      return I != Vec.end();
+    }
+
+    if (!Vector.Index) {
+      Vector.Index = new IndexTy();
+      for (unsigned I = 0, N = Vec.size(); I != N; ++I)
+        (*Vector.Index)[Vec[I]] = I;
+    }
+    IndexTy::iterator Known = Vector.Index->find(D);
+    if (Known == Vector.Index->end())
+      return false;
+    Pos = Known->second;
+    return true;
+  }
+
+  /// replaceDecl - Store \p D at position \p Pos of the vector form.
+  void replaceDecl(unsigned Pos, NamedDecl *D) {
+    VectorTy &Vector = *Data.get<VectorTy *>();
+    if (Vector.Index) {
+      Vector.Index->erase(Vector.Decls[Pos]);
+      (*Vector.Index)[D] = Pos;
+    }
+    Vector.Decls[Pos] = D;
+  }
+
+  /// appendDecl - Add \p D at the end of the vector form.
+  void appendDecl(NamedDecl *D) {
+    VectorTy &Vector = *Data.get<VectorTy *>();
+    if (Vector.Index)
+      (*Vector.Index)[D] = Vector.Decls.size();
+    Vector.Decls.push_back(D);
+  }
+
+  /// invalidateIndex - Drop the index after declarations changed position;
+  /// it is rebuilt by the next findDecl that needs it.
+  void invalidateIndex() {
+    VectorTy &Vector = *Data.get<VectorTy *>();
+    delete Vector.Index;
+    Vector.Index = 0;
   }
 };
 
@@ -19,10 +19,12 @@
 namespace clang {
 
 class ASTConsumer;
+class ASTRecordLayout;
 class CXXBaseSpecifier;
 class DeclarationName;
 class ExternalSemaSource; // layering violation required for downcasting
 class NamedDecl;
+class RecordDecl;
 class Selector;
 class Stmt;
 class TagDecl;
@@ -113,6 +115,12 @@ public:
   /// The default implementation of this method is a no-op.
   virtual CXXBaseSpecifier *GetExternalCXXBaseSpecifiers(uint64_t Offset);
 
+  /// \brief Retrieve the layout of the given record definition, if the
+  /// external source stored one when it was built.
+  ///
+  /// The default implementation of this method is a no-op.
+  virtual const ASTRecordLayout *GetExternalRecordLayout(const RecordDecl *D);
+
   /// \brief Finds all declarations with the given name in the
   /// given context.
   ///
@@ -84,6 +84,8 @@ class ASTRecordLayout {
   CXXRecordLayoutInfo *CXXInfo;
 
   friend class ASTContext;
+  friend class ASTReader;
+  friend class ASTWriter;
 
   ASTRecordLayout(const ASTContext &Ctx, CharUnits size, CharUnits alignment,
                   CharUnits datasize, const uint64_t *fieldoffsets,
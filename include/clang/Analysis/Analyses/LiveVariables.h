@@ -16,6 +16,7 @@
 
 #include "clang/Analysis/AnalysisContext.h"
 #include "clang/AST/Decl.h"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/ImmutableSet.h"
 
@@ -29,20 +30,31 @@ class SourceManager;
   
 class LiveVariables : public ManagedAnalysis {
 public:
+  /// Numbers the statements and variables of a function densely, for
+  /// liveness sets represented as bit vectors.
+  class DenseNumbering;
+
   class LivenessValues {
   public:
 
     llvm::ImmutableSet<const Stmt *> liveStmts;
     llvm::ImmutableSet<const VarDecl *> liveDecls;
+
+    /// When non-null, the sets are represented by liveStmtBits and
+    /// liveDeclBits instead, indexed by this numbering. Bits past the end
+    /// of either vector are clear.
+    const DenseNumbering *numbering;
+    llvm::BitVector liveStmtBits;
+    llvm::BitVector liveDeclBits;
     
     bool equals(const LivenessValues &V) const;
 
     LivenessValues()
-      : liveStmts(0), liveDecls(0) {}
+      : liveStmts(0), liveDecls(0), numbering(0) {}
 
     LivenessValues(llvm::ImmutableSet<const Stmt *> LiveStmts,
                    llvm::ImmutableSet<const VarDecl *> LiveDecls)
-      : liveStmts(LiveStmts), liveDecls(LiveDecls) {}
+      : liveStmts(LiveStmts), liveDecls(LiveDecls), numbering(0) {}
 
     ~LivenessValues() {}
     
@@ -69,7 +81,10 @@ public:
 
   virtual ~LiveVariables();
   
-  /// Compute the liveness information for a given CFG.
+  /// Compute the liveness information for a given CFG. Sets of live
+  /// statements and variables are bit vectors if the CFG has at most
+  /// AnalysisContext::getDenseLivenessLimit() statements, and persistent
+  /// sets otherwise.
   static LiveVariables *computeLiveness(AnalysisContext &analysisContext,
                                         bool killAtAssign);
   
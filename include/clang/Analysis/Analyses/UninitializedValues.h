@@ -41,9 +41,16 @@ public:
 
 struct UninitVariablesAnalysisStats {
   unsigned NumVariablesAnalyzed;
+  /// Tracked variables left out because they are never referenced or are
+  /// initialized by their declaration before every use.
+  unsigned NumVariablesPruned;
   unsigned NumBlockVisits;
 };
 
+/// Return true if \p dc declares any variable the analysis tracks, that is,
+/// if running it on \p dc can report anything at all.
+bool hasTrackedVariables(const DeclContext &dc);
+
 void runUninitializedVariablesAnalysis(const DeclContext &dc, const CFG &cfg,
                                        AnalysisContext &ac,
                                        UninitVariablesHandler &handler,
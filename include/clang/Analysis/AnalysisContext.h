@@ -77,6 +77,8 @@ class AnalysisContext {
   
   bool builtCFG, builtCompleteCFG;
 
+  unsigned denseLivenessLimit;
+
   llvm::OwningPtr<LiveVariables> liveness;
   llvm::OwningPtr<LiveVariables> relaxedLiveness;
   llvm::OwningPtr<ParentMap> PM;
@@ -123,6 +125,15 @@ public:
   bool getAddImplicitDtors() const { return cfgBuildOptions.AddImplicitDtors; }
   bool getAddInitializers() const { return cfgBuildOptions.AddInitializers; }
 
+  /// The default for getDenseLivenessLimit().
+  static const unsigned DefaultDenseLivenessLimit = 2048;
+
+  /// Return the largest CFG, counted in statements, for which LiveVariables
+  /// represents its sets with bit vectors. Larger CFGs use persistent sets,
+  /// which share structure between program points.
+  unsigned getDenseLivenessLimit() const { return denseLivenessLimit; }
+  void setDenseLivenessLimit(unsigned limit) { denseLivenessLimit = limit; }
+
   void registerForcedBlockExpression(const Stmt *stmt);
   const CFGBlock *getBlockForRegisteredExpression(const Stmt *stmt);
   
@@ -174,6 +185,20 @@ class AnalysisContextManager {
   typedef llvm::DenseMap<const Decl*, AnalysisContext*> ContextMap;
   ContextMap Contexts;
   CFG::BuildOptions cfgBuildOptions;
+  unsigned denseLivenessLimit;
+
+  /// Temporary storage for building the CFGs of all contexts.
+  llvm::BumpPtrAllocator cfgScratch;
+
+  /// Contexts built by another client through getSharedContext() that have
+  /// not been asked for by getContext() yet.  Unlike Contexts, these survive
+  /// clear().
+  ContextMap SharedContexts;
+  bool shareMainFileOnly;
+
+  /// Statistics.
+  unsigned NumSharedContexts;
+  unsigned NumSharedContextsReused;
 public:
   AnalysisContextManager(bool useUnoptimizedCFG = false,
                          bool addImplicitDtors = false,
@@ -191,6 +216,28 @@ public:
     return cfgBuildOptions;
   }
 
+  /// Set the dense liveness limit of the AnalysisContexts created from now
+  /// on; see AnalysisContext::getDenseLivenessLimit().
+  unsigned getDenseLivenessLimit() const { return denseLivenessLimit; }
+  void setDenseLivenessLimit(unsigned limit) { denseLivenessLimit = limit; }
+
+  /// Return an AnalysisContext for \p D that a client needing a CFG built
+  /// with \p Options can use in place of its own, and that getContext(D)
+  /// will later return with whatever the client computed in it.  Returns
+  /// null if the CFGs of this manager cannot stand in for such a CFG.
+  AnalysisContext *getSharedContext(const Decl *D,
+                                    const CFG::BuildOptions &Options);
+
+  /// Only share contexts for declarations in the main file.
+  void setShareMainFileOnly(bool value) { shareMainFileOnly = value; }
+
+  /// The number of contexts handed out by getSharedContext(), and the number
+  /// of those whose CFG getContext() reused instead of building it again.
+  unsigned getNumSharedContexts() const { return NumSharedContexts; }
+  unsigned getNumSharedContextsReused() const {
+    return NumSharedContextsReused;
+  }
+
   /// Discard all previously created AnalysisContexts.
   void clear();
 };
@@ -303,6 +303,8 @@ class CFGBlock {
     
     size_t size() const { return Impl.size(); }
     bool empty() const { return Impl.empty(); }
+
+    void relocate(CFGElement *Storage) { Impl.relocate(Storage); }
   };
 
   /// Stmts - The set of statements in the basic block.
@@ -493,6 +495,16 @@ public:
   void print(raw_ostream &OS, const CFG* cfg, const LangOptions &LO) const;
   void printTerminator(raw_ostream &OS, const LangOptions &LO) const;
   
+  /// relocate - Move the elements of this block into Elts, and its
+  ///  predecessors followed by its successors into Adj.  These must have room
+  ///  for size() and pred_size() + succ_size() entries.  Used by
+  ///  CFG::compact().
+  void relocate(CFGElement *Elts, CFGBlock **Adj) {
+    Elements.relocate(Elts);
+    Preds.relocate(Adj);
+    Succs.relocate(Adj + Preds.size());
+  }
+
   void addSuccessor(CFGBlock *Block, BumpVectorContext &C) {
     if (Block)
       Block->Preds.push_back(this, C);
@@ -556,6 +568,11 @@ public:
     typedef llvm::DenseMap<const Stmt *, const CFGBlock*> ForcedBlkExprs;
     ForcedBlkExprs **forcedBlkExprs;    
 
+    /// An allocator the builder may use for temporary storage, and resets
+    /// once the CFG is built.  It lets consecutive builds reuse the same
+    /// memory.  If null, the builder uses an allocator of its own.
+    llvm::BumpPtrAllocator *ScratchAllocator;
+
     bool PruneTriviallyFalseEdges;
     bool AddEHEdges;
     bool AddInitializers;
@@ -575,9 +592,19 @@ public:
       return *this;
     }
 
+    /// Return true if every statement class \p Other always adds is also
+    /// always added by these options.
+    bool alwaysAddsAllOf(const BuildOptions &Other) const {
+      for (int i = Other.alwaysAddMask.find_first(); i != -1;
+           i = Other.alwaysAddMask.find_next(i))
+        if (!alwaysAddMask[i])
+          return false;
+      return true;
+    }
+
     BuildOptions()
     : alwaysAddMask(Stmt::lastStmtConstant, false)
-      ,forcedBlkExprs(0), PruneTriviallyFalseEdges(true)
+      ,forcedBlkExprs(0), ScratchAllocator(0), PruneTriviallyFalseEdges(true)
       ,AddEHEdges(false)
       ,AddInitializers(false)
       ,AddImplicitDtors(false) {}
@@ -590,7 +617,18 @@ public:
 
   /// createBlock - Create a new block in the CFG.  The CFG owns the block;
   ///  the caller should not directly free it.
-  CFGBlock *createBlock();
+  CFGBlock *createBlock() { return createBlock(BlkBVC); }
+
+  /// createBlock - Create a new block whose lists, like the list of blocks
+  ///  itself, grow in the context C until compact() is called.
+  CFGBlock *createBlock(BumpVectorContext &C);
+
+  /// compact - Move the elements and adjacency lists of all blocks, and the
+  ///  list of blocks, into exactly sized arrays in the CFG's own allocator.
+  ///  The elements of all blocks end up in one array, in block order, and so
+  ///  do their predecessors and successors.  After this, nothing the CFG
+  ///  uses lives in the context passed to createBlock().
+  void compact();
 
   /// setEntry - Set the entry block of the CFG.  This is typically used
   ///  only during CFG construction.  Most CFG clients expect that the
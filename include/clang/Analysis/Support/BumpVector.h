@@ -183,6 +183,23 @@ public:
   /// capacity - Return the total number of elements in the currently allocated
   /// buffer.
   size_t capacity() const { return Capacity - Begin; }  
+
+  /// relocate - Move the elements into the buffer at NewElts, which must have
+  /// room for size() elements, and drop any spare capacity.  The old buffer
+  /// is leaked like in grow(), so this is used to move vectors out of an
+  /// allocator that is about to be reset.
+  void relocate(T *NewElts) {
+    size_t CurSize = size();
+    if (llvm::is_class<T>::value) {
+      std::uninitialized_copy(Begin, End, NewElts);
+      destroy_range(Begin, End);
+    }
+    else {
+      memcpy(NewElts, Begin, CurSize * sizeof(T));
+    }
+    Begin = NewElts;
+    End = Capacity = NewElts+CurSize;
+  }
     
 private:
   /// grow - double the size of the allocated memory, guaranteeing space for at
@@ -20,10 +20,12 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/type_traits.h"
 
 #include <vector>
 #include <list>
+#include <map>
 
 namespace clang {
   class DiagnosticConsumer;
@@ -226,6 +228,50 @@ private:
   /// so we can get back at it when we 'pop'.
   std::vector<DiagState *> DiagStateOnPushStack;
 
+  /// \brief The changes of diagnostic state as seen from within one file.
+  ///
+  /// A change is recorded at its offset in the file of the pragma, and at
+  /// the offset of the include in each file that includes it, so that the
+  /// state at a location is found by a binary search in its own file rather
+  /// than by comparing locations across include stacks.
+  struct DiagStateFile {
+    /// \brief The entry of the including file, or null for a file that is
+    /// not included from another one.
+    DiagStateFile *Parent;
+
+    /// \brief The offset of the include within the parent file.
+    unsigned ParentOffset;
+
+    /// \brief The state at the start of the file followed by each change of
+    /// state within it, sorted by offset.
+    SmallVector<std::pair<unsigned, DiagState *>, 2> Transitions;
+
+    DiagStateFile() : Parent(0), ParentOffset(0) { }
+
+    /// \brief Returns the state in effect at the given offset.
+    DiagState *lookup(unsigned Offset) const;
+
+    /// \brief Returns true if the state changes at exactly the given
+    /// offset.
+    bool hasTransitionAt(unsigned Offset) const;
+  };
+
+  /// \brief The DiagStateFile of each file in which the diagnostic state
+  /// changed or was queried, mirroring DiagStatePoints.
+  mutable std::map<FileID, DiagStateFile> DiagStateFiles;
+
+  /// \brief Set when a DiagStatePoint was inserted out of order, in which
+  /// case DiagStateFiles is rebuilt before the next query.
+  mutable bool DiagStateFilesInvalid;
+
+  /// \brief Returns the DiagStateFile of the given file, creating it if
+  /// needed.
+  DiagStateFile &getDiagStateFile(FileID FID) const;
+
+  /// \brief Records in DiagStateFiles that \p State is in effect from the
+  /// given location on.
+  void addDiagStateTransition(SourceLocation Loc, DiagState *State) const;
+
   DiagState *GetCurDiagState() const {
     assert(!DiagStatePoints.empty());
     return DiagStatePoints.back().State;
@@ -242,12 +288,18 @@ private:
            "Previous point loc comes after or is the same as new one");
     DiagStatePoints.push_back(DiagStatePoint(State,
                                              FullSourceLoc(Loc, *SourceMgr)));
+    if (Loc.isValid() && !DiagStateFilesInvalid)
+      addDiagStateTransition(Loc, State);
   }
 
   /// \brief Finds the DiagStatePoint that contains the diagnostic state of
   /// the given source location.
   DiagStatePointsTy::iterator GetDiagStatePointForLoc(SourceLocation Loc) const;
 
+  /// \brief Returns the diagnostic state in effect at the given source
+  /// location, or the latest one if the location is invalid.
+  DiagState *GetDiagStateForLoc(SourceLocation Loc) const;
+
   /// ErrorOccurred / FatalErrorOccurred - This is set to true when an error or
   /// fatal error is emitted, and is sticky.
   bool ErrorOccurred;
@@ -34,6 +34,12 @@ public:
     SOB_Trapping    // -ftrapv
   };
 
+  enum ConstantEvaluatorKind {
+    CE_Tree,        // Walk the AST (the default).
+    CE_Bytecode,    // Compile integer constant expressions to bytecode.
+    CE_Check        // Use both, and check that they agree.
+  };
+
   // Define simple language options (with no accessors).
 #define LANGOPT(Name, Bits, Default, Description) unsigned Name : Bits;
 #define ENUM_LANGOPT(Name, Type, Bits, Default, Description)
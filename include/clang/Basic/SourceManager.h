@@ -562,6 +562,36 @@ class SourceManager : public llvm::RefCountedBase<SourceManager> {
   // Cache results for the isBeforeInTranslationUnit method.
   mutable IsBeforeInTranslationUnitCache IsBeforeInTUCache;
 
+  /// \brief A FileID's position in the tree of #includes and macro
+  /// expansions, used by isBeforeInTranslationUnit to find the nearest
+  /// common ancestor of two FileIDs without decomposing source locations.
+  struct IncludeTreeNode {
+    /// \brief The FileID this one was included or expanded into, or an
+    /// invalid FileID for a top-level buffer.
+    FileID Parent;
+
+    /// \brief The offset within Parent of the #include or expansion.
+    unsigned ParentOffset;
+
+    /// \brief The number of ancestors, or ~0U if not yet computed.
+    unsigned Depth;
+
+    /// \brief An ancestor to skip to when walking up the tree. These form
+    /// skew-binary jumps, so that any ancestor is reached in a logarithmic
+    /// number of steps. A top-level buffer jumps to itself.
+    FileID Jump;
+
+    IncludeTreeNode() : ParentOffset(0), Depth(~0U) { }
+  };
+
+  /// \brief Lazily computed include tree nodes for local FileIDs, indexed
+  /// like LocalSLocEntryTable.
+  mutable std::vector<IncludeTreeNode> LocalIncludeTree;
+
+  /// \brief Lazily computed include tree nodes for loaded FileIDs, indexed
+  /// like LoadedSLocEntryTable.
+  mutable std::vector<IncludeTreeNode> LoadedIncludeTree;
+
   // Cache for the "fake" buffer used for error-recovery purposes.
   mutable llvm::MemoryBuffer *FakeBufferForRecovery;
 
@@ -1318,6 +1348,11 @@ private:
                                    unsigned Offset) const;
   void computeMacroArgsCache(MacroArgsMap *&MacroArgsCache, FileID FID) const;
 
+  IncludeTreeNode &getIncludeTreeSlot(FileID FID) const;
+  IncludeTreeNode getIncludeTreeNode(FileID FID) const;
+  void moveUpIncludeTree(std::pair<FileID, unsigned> &Loc,
+                         IncludeTreeNode &Node, unsigned Depth) const;
+
   friend class ASTReader;
   friend class ASTWriter;
 };
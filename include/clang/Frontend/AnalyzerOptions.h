@@ -60,6 +60,14 @@ enum AnalysisPurgeMode {
 NumPurgeModes
 };
 
+/// AnalysisLivenessMode - Set of available representations for the live
+///  variables analysis.
+enum AnalysisLivenessMode {
+#define ANALYSIS_LIVENESS(NAME, CMDFLAG, DESC) NAME,
+#include "clang/Frontend/Analyses.def"
+NumLivenessModes
+};
+
 class AnalyzerOptions {
 public:
   /// \brief Pair of checker name and enable/disable.
@@ -68,12 +76,14 @@ public:
   AnalysisConstraints AnalysisConstraintsOpt;
   AnalysisDiagClients AnalysisDiagOpt;
   AnalysisPurgeMode AnalysisPurgeOpt;
+  AnalysisLivenessMode AnalysisLivenessOpt;
   std::string AnalyzeSpecificFunction;
   unsigned MaxNodes;
   unsigned MaxLoop;
   unsigned ShowCheckerHelp : 1;
   unsigned AnalyzeAll : 1;
   unsigned AnalyzerDisplayProgress : 1;
+  unsigned CheckerStats : 1;
   unsigned AnalyzeNestedBlocks : 1;
   unsigned EagerlyAssume : 1;
   unsigned TrimGraph : 1;
@@ -91,9 +101,11 @@ public:
     AnalysisConstraintsOpt = RangeConstraintsModel;
     AnalysisDiagOpt = PD_HTML;
     AnalysisPurgeOpt = PurgeStmt;
+    AnalysisLivenessOpt = LivenessAuto;
     ShowCheckerHelp = 0;
     AnalyzeAll = 0;
     AnalyzerDisplayProgress = 0;
+    CheckerStats = 0;
     AnalyzeNestedBlocks = 0;
     EagerlyAssume = 0;
     TrimGraph = 0;
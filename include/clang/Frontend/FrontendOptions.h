@@ -69,6 +69,9 @@ public:
                                            /// metrics and statistics.
   unsigned ShowTimers : 1;                 ///< Show timers for individual
                                            /// actions.
+  unsigned ShowTemplateInstantiationProfile : 1; ///< Show the time and memory
+                                                 /// spent per template
+                                                 /// instantiation.
   unsigned ShowVersion : 1;                ///< Show the -version text.
   unsigned FixWhatYouCan : 1;              ///< Apply fixes even if there are
                                            /// unfixable errors.
@@ -91,6 +94,10 @@ public:
   /// The output file, if any.
   std::string OutputFile;
 
+  /// If given, the file to write a trace of the template instantiations
+  /// performed to, in the Chrome trace-event format.
+  std::string TemplateInstantiationTraceFile;
+
   /// If given, the new suffix for fix-it rewritten files.
   std::string FixItSuffix;
 
@@ -134,6 +141,7 @@ public:
     ShowGlobalSymbolsInCodeCompletion = 1;
     ShowStats = 0;
     ShowTimers = 0;
+    ShowTemplateInstantiationProfile = 0;
     ShowVersion = 0;
     ARCMTAction = ARCMT_None;
     ARCMTMigrateEmitARCErrors = 0;
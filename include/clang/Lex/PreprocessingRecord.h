@@ -315,6 +315,18 @@ namespace clang {
     /// \brief External source of preprocessed entities.
     ExternalPreprocessingRecordSource *ExternalSource;
 
+    /// \brief The result of the last getPreprocessedEntitiesInRange query,
+    /// as a pair of [Begin, End) entity IDs. libclang tends to ask for the
+    /// same range several times in a row, e.g. once to mark macro argument
+    /// tokens and once to annotate them.
+    struct {
+      SourceRange Range;
+      std::pair<PPEntityID, PPEntityID> Result;
+    } CachedRangeQuery;
+
+    std::pair<PPEntityID, PPEntityID>
+      getPreprocessedEntitiesInRangeSlow(SourceRange R);
+
     /// \brief Retrieve the preprocessed entity at the given ID.
     PreprocessedEntity *getPreprocessedEntity(PPEntityID PPID);
 
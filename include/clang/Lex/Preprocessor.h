@@ -266,6 +266,7 @@ class Preprocessor : public llvm::RefCountedBase<Preprocessor> {
   unsigned NumEnteredSourceFiles, MaxIncludeStackDepth;
   unsigned NumMacroExpanded, NumFnMacroExpanded, NumBuiltinMacroExpanded;
   unsigned NumFastMacroExpanded, NumTokenPaste, NumFastTokenPaste;
+  unsigned NumMacroArgsPreExpanded, NumMacroArgsPreExpReused;
   unsigned NumSkipped;
 
   /// Predefines - This string is the predefined macros that preprocessor
@@ -1101,6 +1102,13 @@ private:
   /// the macro should not be expanded return true, otherwise return false.
   bool HandleMacroExpandedIdentifier(Token &Tok, MacroInfo *MI);
 
+  /// ExpandObjectLikeMacroChain - MI is a single-token macro whose replacement
+  /// token names another enabled macro, as in "#define FOO BAR".  If every
+  /// link of the chain is a single-token object-like macro, splice the final
+  /// token in directly instead of pushing a TokenLexer for each link.  Returns
+  /// false without modifying Tok if the chain can't be collapsed.
+  bool ExpandObjectLikeMacroChain(Token &Tok, MacroInfo *MI);
+
   /// \brief Cache macro expanded tokens for TokenLexers.
   //
   /// Works like a stack; a TokenLexer adds the macro expanded tokens that is
@@ -15,9 +15,11 @@
 #define LLVM_CLANG_SEMA_ANALYSIS_WARNINGS_H
 
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Allocator.h"
 
 namespace clang {
 
+class AnalysisContextManager;
 class BlockExpr;
 class Decl;
 class FunctionDecl;
@@ -47,6 +49,13 @@ private:
   Sema &S;
   Policy DefaultPolicy;
 
+  /// \brief If set, the manager of a later client, such as the static
+  /// analyzer, that wants to reuse the CFGs built for these warnings.
+  AnalysisContextManager *SharedContexts;
+
+  /// \brief Temporary storage for building CFGs, reused across functions.
+  llvm::BumpPtrAllocator CFGScratch;
+
   enum VisitFlag { NotVisited = 0, Visited = 1, Pending = 2 };
   llvm::DenseMap<const FunctionDecl*, VisitFlag> VisitedFD;
 
@@ -60,12 +69,22 @@ private:
   /// built.
   unsigned NumFunctionsWithBadCFGs;
 
+  /// \brief Number of functions for which no analysis could report anything,
+  /// so that no CFG was built.
+  unsigned NumFunctionsWithoutCFGs;
+
   /// \brief Total number of blocks across all CFGs.
   unsigned NumCFGBlocks;
 
   /// \brief Largest number of CFG blocks for a single function analyzed.
   unsigned MaxCFGBlocksPerFunction;
 
+  /// \brief Total memory allocated by all CFGs, in bytes.
+  size_t NumCFGBytes;
+
+  /// \brief Largest memory allocated by a single CFG, in bytes.
+  size_t MaxCFGBytesPerFunction;
+
   /// \brief Total number of CFGs with variables analyzed for uninitialized
   /// uses.
   unsigned NumUninitAnalysisFunctions;
@@ -73,6 +92,10 @@ private:
   /// \brief Total number of variables analyzed for uninitialized uses.
   unsigned NumUninitAnalysisVariables;
 
+  /// \brief Total number of variables the uninitialized use analysis could
+  /// leave out without analyzing them.
+  unsigned NumUninitAnalysisVariablesPruned;
+
   /// \brief Max number of variables analyzed for uninitialized uses in a single
   /// function.
   unsigned MaxUninitAnalysisVariablesPerFunction;
@@ -94,6 +117,11 @@ public:
 
   Policy getDefaultPolicy() { return DefaultPolicy; }
 
+  /// \brief Build the analysis contexts of the functions analyzed from now
+  /// on through \p ACM where possible, so its client does not have to build
+  /// them again.  Pass null to stop sharing.
+  void setSharedContexts(AnalysisContextManager *ACM) { SharedContexts = ACM; }
+
   void PrintStats() const;
 };
 
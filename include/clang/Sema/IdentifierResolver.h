@@ -16,6 +16,7 @@
 #define LLVM_CLANG_AST_SEMA_IDENTIFIERRESOLVER_H
 
 #include "clang/Basic/IdentifierTable.h"
+#include "llvm/ADT/DenseMap.h"
 
 namespace clang {
 
@@ -35,19 +36,35 @@ class IdentifierResolver {
   /// to a particular declaration name. IdDeclInfos are lazily
   /// constructed and assigned to a declaration name the first time a
   /// decl with that declaration name is shadowed in some scope.
+  ///
+  /// Long chains (e.g. a name overloaded many times in one namespace) get an
+  /// index from each decl to its position, and removed decls leave a null
+  /// slot behind that is skipped by iterators until the chain is compacted,
+  /// so that removing a decl does not take time linear in the chain.
   class IdDeclInfo {
   public:
     typedef SmallVector<NamedDecl*, 2> DeclsTy;
 
+    IdDeclInfo() : Index(0), NumRemoved(0) {}
+    ~IdDeclInfo() { delete Index; }
+
     inline DeclsTy::iterator decls_begin() { return Decls.begin(); }
     inline DeclsTy::iterator decls_end() { return Decls.end(); }
 
-    void AddDecl(NamedDecl *D) { Decls.push_back(D); }
+    void AddDecl(NamedDecl *D) {
+      if (Index)
+        (*Index)[D] = Decls.size();
+      Decls.push_back(D);
+    }
 
     /// RemoveDecl - Remove the decl from the scope chain.
     /// The decl must already be part of the decl chain.
     void RemoveDecl(NamedDecl *D);
 
+    /// Removes the decl from the scope chain if it is part of it. Returns
+    /// true if the decl was found.
+    bool tryRemoveDecl(NamedDecl *D);
+
     /// Replaces the Old declaration with the New declaration. If the
     /// replacement is successful, returns true. If the old
     /// declaration was not found, returns false.
@@ -56,10 +73,31 @@ class IdentifierResolver {
     /// \brief Insert the given declaration at the given position in the list.
     void InsertDecl(DeclsTy::iterator Pos, NamedDecl *D) {
       Decls.insert(Pos, D);
+      invalidateIndex();
     }
                     
   private:
+    typedef llvm::DenseMap<NamedDecl*, unsigned> IndexTy;
+
+    /// The number of entries at which removals go through the index.
+    static const unsigned IndexThreshold = 16;
+
     DeclsTy Decls;
+
+    /// The position of each decl in Decls, built on the first removal from
+    /// a chain of at least IndexThreshold entries.
+    IndexTy *Index;
+
+    /// The number of null slots left in Decls by removed decls.
+    unsigned NumRemoved;
+
+    void invalidateIndex() {
+      delete Index;
+      Index = 0;
+    }
+
+    /// Drop the null slots of removed decls from Decls.
+    void compact();
   };
 
 public:
@@ -166,6 +204,10 @@ public:
   /// The decl must already be part of the decl chain.
   void RemoveDecl(NamedDecl *D);
 
+  /// \brief Unlink the decl from its shadowed decl chain if it is part of
+  /// it. Returns true if the decl was found (and, therefore, removed).
+  bool tryRemoveDecl(NamedDecl *D);
+
   /// Replace the decl Old with the new declaration New on its
   /// identifier chain. Returns true if the old declaration was found
   /// (and, therefore, replaced).
@@ -22,6 +22,7 @@
 #include "clang/AST/Type.h"
 #include "clang/AST/UnresolvedSet.h"
 #include "clang/Sema/SemaFixItUtils.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 
@@ -668,6 +669,31 @@ namespace clang {
     llvm::SmallPtrSet<Decl *, 16> Functions;
 
     SourceLocation Loc;    
+
+  public:
+    /// \brief The key of a cached conversion sequence: the argument, the
+    /// canonical parameter type, and whether user-defined conversions were
+    /// suppressed.
+    typedef std::pair<Expr *, std::pair<void *, unsigned> > ConversionKey;
+
+    /// \brief A cached conversion sequence, along with the type of the
+    /// argument it was computed for.
+    struct CachedConversion {
+      QualType FromType;
+      ImplicitConversionSequence ICS;
+    };
+
+  private:
+    /// \brief The implicit conversion sequences computed for the arguments
+    /// of the candidates in this set.  Candidates of a large overload set
+    /// (e.g., operator<<) often share parameter types, so each argument only
+    /// has to be converted to each distinct parameter type once.
+    llvm::DenseMap<ConversionKey, CachedConversion> Conversions;
+
+    /// \brief The number of candidates a set must have before conversions
+    /// are cached.  Small sets rarely convert an argument to the same type
+    /// twice, so filling the cache would only cost time and memory.
+    static const unsigned ConversionCacheThreshold = 4;
     
     OverloadCandidateSet(const OverloadCandidateSet &);
     OverloadCandidateSet &operator=(const OverloadCandidateSet &);
@@ -686,6 +712,45 @@ namespace clang {
     /// \brief Clear out all of the candidates.
     void clear();
 
+    /// \brief Find the conversion sequence computed earlier for converting
+    /// the given argument to the given parameter type, if any.
+    const ImplicitConversionSequence *
+    getCachedConversion(Expr *From, QualType ToType,
+                        bool SuppressUserConversions) const {
+      llvm::DenseMap<ConversionKey, CachedConversion>::const_iterator Known
+        = Conversions.find(getConversionKey(From, ToType,
+                                            SuppressUserConversions));
+      if (Known == Conversions.end() ||
+          Known->second.FromType != From->getType())
+        return 0;
+      return &Known->second.ICS;
+    }
+
+    /// \brief Remember the conversion sequence computed for converting the
+    /// given argument to the given parameter type, once the set is large
+    /// enough for other candidates to be likely to need it.
+    void cacheConversion(Expr *From, QualType ToType,
+                         bool SuppressUserConversions,
+                         const ImplicitConversionSequence &ICS) {
+      if (size() < ConversionCacheThreshold)
+        return;
+      CachedConversion &Entry
+        = Conversions[getConversionKey(From, ToType, SuppressUserConversions)];
+      Entry.FromType = From->getType();
+      Entry.ICS = ICS;
+    }
+
+  private:
+    static ConversionKey getConversionKey(Expr *From, QualType ToType,
+                                          bool SuppressUserConversions) {
+      return ConversionKey(From,
+                           std::make_pair(ToType.getCanonicalType()
+                                            .getAsOpaquePtr(),
+                                          (unsigned)SuppressUserConversions));
+    }
+
+  public:
+
     /// Find the best viable function on this overload set, if it exists.
     OverloadingResult BestViableFunction(Sema &S, SourceLocation Loc,
                                          OverloadCandidateSet::iterator& Best,
@@ -163,6 +163,7 @@ namespace sema {
   class DelayedDiagnostic;
   class FunctionScopeInfo;
   class TemplateDeductionInfo;
+  class TemplateInstantiationProfiler;
 }
 
 // FIXME: No way to easily map from TemplateTypeParmTypes to
@@ -646,6 +647,23 @@ public:
   /// \brief The number of SFINAE diagnostics that have been trapped.
   unsigned NumSFINAEErrors;
 
+  /// \name Overload resolution statistics
+  /// @{
+
+  /// \brief Number of argument conversion sequences computed for overload
+  /// candidates.
+  unsigned NumOverloadConversionsComputed;
+
+  /// \brief Number of argument conversion sequences reused from another
+  /// candidate of the same overload set.
+  unsigned NumOverloadConversionsReused;
+
+  /// \brief Number of argument conversions rejected by the cheap type check
+  /// before computing a conversion sequence.
+  unsigned NumOverloadConversionsPrefiltered;
+
+  /// @}
+
   typedef llvm::DenseMap<ParmVarDecl *, SmallVector<ParmVarDecl *, 1> >
     UnparsedDefaultArgInstantiationsMap;
   
@@ -4710,6 +4728,19 @@ public:
   /// therefore, should not be counted as part of the instantiation depth.
   unsigned NonInstantiationEntries;
 
+  /// \brief If non-null, the profiler notified of every entry pushed onto
+  /// and popped from \c ActiveTemplateInstantiations.
+  llvm::OwningPtr<sema::TemplateInstantiationProfiler> InstantiationProfiler;
+
+  /// \brief Start accounting the time and memory spent in each template
+  /// instantiation.  If \p RecordTrace, also record each individual
+  /// instantiation for TemplateInstantiationProfiler::writeTraceEvents.
+  void enableTemplateInstantiationProfiling(bool RecordTrace);
+
+  sema::TemplateInstantiationProfiler *getTemplateInstantiationProfiler() {
+    return InstantiationProfiler.get();
+  }
+
   /// \brief The last template from which a template instantiation
   /// error or warning was produced.
   ///
@@ -4855,6 +4886,7 @@ public:
     bool SavedInNonInstantiationSFINAEContext;
     bool CheckInstantiationDepth(SourceLocation PointOfInstantiation,
                                  SourceRange InstantiationRange);
+    void PushInstantiation(const ActiveTemplateInstantiation &Inst);
 
     InstantiatingTemplate(const InstantiatingTemplate&); // not implemented
 
@@ -0,0 +1,111 @@
+//===--- TemplateInstantiationProfiler.h - Profile instantiations -*- C++ -*-=//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines TemplateInstantiationProfiler, which accounts the time
+// and AST memory spent in each entry of Sema's template instantiation stack.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_SEMA_TEMPLATE_INSTANTIATION_PROFILER_H
+#define LLVM_CLANG_SEMA_TEMPLATE_INSTANTIATION_PROFILER_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/DataTypes.h"
+#include <string>
+#include <vector>
+
+namespace clang {
+
+class ASTContext;
+
+namespace sema {
+
+/// \brief Records wall time, bytes allocated in the ASTContext and the number
+/// of nested instantiations for every entry pushed onto
+/// Sema::ActiveTemplateInstantiations, aggregated per (kind, entity) pair.
+///
+/// Times and sizes are inclusive of nested instantiations.  The profiler can
+/// also record every individual instantiation as a Chrome trace event.
+class TemplateInstantiationProfiler {
+public:
+  /// \brief The accumulated cost of one instantiated entity.
+  struct Entry {
+    /// \brief The Sema::ActiveTemplateInstantiation::InstantiationKind.
+    unsigned Kind;
+
+    /// \brief The entity being instantiated or substituted into.
+    uintptr_t Entity;
+
+    /// \brief Number of times this entity was pushed onto the stack.
+    unsigned Count;
+
+    /// \brief Number of instantiations performed while this one was active.
+    unsigned NestedInstantiations;
+
+    /// \brief Wall time spent, in seconds.
+    double WallTime;
+
+    /// \brief Bytes allocated in the ASTContext.
+    uint64_t BytesAllocated;
+
+    Entry(unsigned Kind, uintptr_t Entity)
+      : Kind(Kind), Entity(Entity), Count(0), NestedInstantiations(0),
+        WallTime(0), BytesAllocated(0) { }
+  };
+
+private:
+  /// \brief An instantiation currently on the stack.
+  struct Frame {
+    unsigned EntryIndex;
+    double StartTime;
+    size_t StartBytes;
+    unsigned Nested;
+  };
+
+  /// \brief One completed instantiation, for the trace output.
+  struct TraceEvent {
+    unsigned EntryIndex;
+    double StartTime;
+    double Duration;
+  };
+
+  ASTContext &Context;
+  bool RecordTrace;
+  double ProfileStartTime;
+
+  std::vector<Entry> Entries;
+  llvm::DenseMap<std::pair<uintptr_t, unsigned>, unsigned> EntryIndices;
+  SmallVector<Frame, 16> Stack;
+  std::vector<TraceEvent> TraceEvents;
+
+  std::string getEntryName(const Entry &E) const;
+
+public:
+  TemplateInstantiationProfiler(ASTContext &Context, bool RecordTrace);
+
+  /// \brief Note that an entry of the given kind for Entity was pushed onto
+  /// the instantiation stack.
+  void startInstantiation(unsigned Kind, uintptr_t Entity);
+
+  /// \brief Note that the innermost active entry was popped.
+  void finishInstantiation();
+
+  /// \brief Print the entries, most expensive first, as a table.
+  void printReport(raw_ostream &OS) const;
+
+  /// \brief Write the recorded instantiations in the Chrome trace-event JSON
+  /// format, viewable in chrome://tracing.
+  void writeTraceEvents(raw_ostream &OS) const;
+};
+
+}} // end namespace clang::sema
+
+#endif
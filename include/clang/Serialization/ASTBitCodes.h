@@ -420,7 +420,11 @@ namespace clang {
 
       /// \brief Record code for ObjC categories in a module that are chained to
       /// an interface.
-      OBJC_CHAINED_CATEGORIES
+      OBJC_CHAINED_CATEGORIES = 49,
+
+      /// \brief Record code for the record layouts that were computed while
+      /// building this AST file.
+      RECORD_LAYOUTS = 50
     };
 
     /// \brief Record types used within a source manager block.
@@ -326,6 +326,24 @@ private:
   /// other modules.
   llvm::DenseSet<serialization::GlobalDeclID> ObjCChainedCategoriesInterfaces;
 
+  typedef llvm::DenseMap<serialization::GlobalDeclID,
+                         std::pair<Module *, unsigned> >
+      RecordLayoutOffsetMap;
+  /// \brief Records whose layout was stored in an AST file and that have not
+  /// been deserialized yet, mapped to the position of the layout within the
+  /// RECORD_LAYOUTS record of that file.
+  RecordLayoutOffsetMap RecordLayoutOffsets;
+
+  typedef llvm::DenseMap<const RecordDecl *, std::pair<Module *, unsigned> >
+      PendingRecordLayoutMap;
+  /// \brief Deserialized records whose stored layout has not been requested
+  /// yet.
+  PendingRecordLayoutMap PendingRecordLayouts;
+
+  /// \brief The target and language properties of this compilation that
+  /// stored record layouts have to match, formed when first needed.
+  SmallVector<uint64_t, 40> RecordLayoutSignature;
+
   /// \brief Read the records that describe the contents of declcontexts.
   bool ReadDeclContextStorage(Module &M, 
                               llvm::BitstreamCursor &Cursor,
@@ -543,6 +561,14 @@ private:
   /// in the chain.
   unsigned TotalNumStatements;
 
+  /// \brief The number of definitions of implicit template instantiations
+  /// de-serialized from the chain.
+  unsigned NumInstantiationsRead;
+
+  /// \brief The number of record layouts read from the chain rather than
+  /// computed.
+  unsigned NumRecordLayoutsRead;
+
   /// \brief The number of macros de-serialized from the chain.
   unsigned NumMacrosRead;
 
@@ -937,6 +963,11 @@ public:
                                  unsigned &Idx);
       
   virtual CXXBaseSpecifier *GetExternalCXXBaseSpecifiers(uint64_t Offset);
+
+  /// \brief Build the layout of the given record from the one stored in the
+  /// AST file that declared it, if that file was built for a compatible
+  /// target.
+  virtual const ASTRecordLayout *GetExternalRecordLayout(const RecordDecl *D);
       
   /// \brief Resolve the offset of a statement into a statement.
   ///
@@ -359,6 +359,7 @@ private:
   void WriteDeclReplacementsBlock();
   void ResolveChainedObjCCategories();
   void WriteChainedObjCCategories();
+  void AddRecordLayouts(ASTContext &Context, RecordDataImpl &Record);
   void WriteDeclContextVisibleUpdate(const DeclContext *DC);
   void WriteFPPragmaOptions(const FPOptions &Opts);
   void WriteOpenCLExtensions(Sema &SemaRef);
@@ -271,6 +271,10 @@ public:
   /// Key is the ID of the interface.
   /// Value is a pair of linked category DeclIDs (head category, tail category).
   ChainedObjCCategoriesMap ChainedObjCCategories;
+
+  /// \brief The contents of the RECORD_LAYOUTS record, from which record
+  /// layouts are decoded on demand.
+  SmallVector<uint64_t, 8> RecordLayouts;
   
   // === Types ===
   
@@ -18,6 +18,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/FoldingSet.h"
+#include "llvm/Support/Timer.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/Store.h"
 #include <vector>
 
@@ -107,7 +108,8 @@ class CheckerManager {
   const LangOptions LangOpts;
 
 public:
-  CheckerManager(const LangOptions &langOpts) : LangOpts(langOpts) { }
+  CheckerManager(const LangOptions &langOpts)
+    : LangOpts(langOpts), CollectCheckerStats(false) { }
   ~CheckerManager();
 
   bool hasPathSensitiveCheckers() const;
@@ -136,11 +138,46 @@ public:
 
     CHECKER *checker = new CHECKER();
     CheckerDtors.push_back(CheckerDtor(checker, destruct<CHECKER>));
+    CheckerStatsMap[checker].Name = CurrentCheckerName;
     CHECKER::_register(checker, *this);
     ref = checker;
     return checker;
   }
 
+  /// \brief Set the name under which the checkers registered from now on
+  /// are reported in the checker statistics.
+  void setCurrentCheckerName(StringRef name) { CurrentCheckerName = name; }
+
+//===----------------------------------------------------------------------===//
+// Checker statistics
+//===----------------------------------------------------------------------===//
+
+  /// \brief The time, callbacks, and exploded nodes charged to a checker.
+  ///
+  /// Times are inclusive: a callback that makes the engine run other
+  /// checkers is charged for their time as well.
+  struct CheckerStats {
+    std::string Name;
+    llvm::TimeRecord Time;
+    unsigned NumCallbacks;
+    unsigned NumNodes;
+
+    CheckerStats() : NumCallbacks(0), NumNodes(0) { }
+  };
+
+  /// \brief Start charging every checker callback to its checker.
+  void enableCheckerStats() { CollectCheckerStats = true; }
+
+  bool hasCheckerStats() const { return CollectCheckerStats; }
+
+  /// \brief Charge a callback that took \p time and created \p numNodes
+  /// exploded nodes to \p checker.
+  void recordCheckerCallback(const CheckerBase *checker,
+                             const llvm::TimeRecord &time, unsigned numNodes);
+
+  /// \brief Print the statistics of the checkers that ran, slowest first.
+  void printCheckerStats(raw_ostream &Out) const;
+
 //===----------------------------------------------------------------------===//
 // Functions for running checkers for AST traversing..
 //===----------------------------------------------------------------------===//
@@ -444,6 +481,10 @@ private:
 
   std::vector<CheckerDtor> CheckerDtors;
 
+  bool CollectCheckerStats;
+  std::string CurrentCheckerName;
+  llvm::DenseMap<const CheckerBase *, CheckerStats> CheckerStatsMap;
+
   struct DeclCheckerInfo {
     CheckDeclFunc CheckFn;
     HandlesDeclFunc IsForDeclFn;
@@ -67,6 +67,12 @@ class ExprEngine : public SubEngine {
   /// currentStmt - The current block-level statement.
   const Stmt *currentStmt;
 
+  /// The number of statements before which dead bindings were removed, and
+  ///  the number for which the sweep was postponed because nothing could
+  ///  have died since the previous one.
+  unsigned NumDeadBindingSweeps;
+  unsigned NumDeadBindingSweepsSkipped;
+
   /// Obj-C Class Identifiers.
   IdentifierInfo* NSExceptionII;
 
@@ -130,6 +136,11 @@ public:
   ExplodedGraph& getGraph() { return G; }
   const ExplodedGraph& getGraph() const { return G; }
 
+  unsigned getNumDeadBindingSweeps() const { return NumDeadBindingSweeps; }
+  unsigned getNumDeadBindingSweepsSkipped() const {
+    return NumDeadBindingSweepsSkipped;
+  }
+
   /// processCFGElement - Called by CoreEngine. Used to generate new successor
   ///  nodes by processing the 'effects' of a CFG element.
   void processCFGElement(const CFGElement E, StmtNodeBuilder& builder);
@@ -435,6 +435,11 @@ private:
   /// A vector of ProgramStates that we can reuse.
   std::vector<ProgramState *> freeStates;
 
+  /// Statistics.
+  unsigned NumStateLookups;
+  unsigned NumStatesShared;
+  unsigned NumStatesRecycled;
+
 public:
   ProgramStateManager(ASTContext &Ctx,
                  StoreManagerCreator CreateStoreManager,
@@ -445,7 +450,8 @@ public:
       EnvMgr(alloc),
       GDMFactory(alloc),
       svalBuilder(createSimpleSValBuilder(alloc, Ctx, *this)),
-      Alloc(alloc) {
+      Alloc(alloc), NumStateLookups(0), NumStatesShared(0),
+      NumStatesRecycled(0) {
     StoreMgr.reset((*CreateStoreManager)(*this));
     ConstraintMgr.reset((*CreateConstraintManager)(*this, subeng));
   }
@@ -458,7 +464,8 @@ public:
       EnvMgr(alloc),
       GDMFactory(alloc),
       svalBuilder(createSimpleSValBuilder(alloc, Ctx, *this)),
-      Alloc(alloc) {
+      Alloc(alloc), NumStateLookups(0), NumStatesShared(0),
+      NumStatesRecycled(0) {
     StoreMgr.reset((*CreateStoreManager)(*this));
     ConstraintMgr.reset(ConstraintManagerPtr);
   }
@@ -541,6 +548,13 @@ public:
   /// created but never used for creating an ExplodedNode.
   void recycleUnusedStates();
 
+  /// The number of states looked up with getPersistentState(), the number
+  /// of those that already existed, and the number of states recycled.
+  /// The states created are NumStateLookups - NumStatesShared.
+  unsigned getNumStateLookups() const { return NumStateLookups; }
+  unsigned getNumStatesShared() const { return NumStatesShared; }
+  unsigned getNumStatesRecycled() const { return NumStatesRecycled; }
+
   //==---------------------------------------------------------------------==//
   // Generic Data Map methods.
   //==---------------------------------------------------------------------==//
@@ -13,6 +13,7 @@
 
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/CharUnits.h"
+#include "clang/AST/DeclContextInternals.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclObjC.h"
 #include "clang/AST/DeclTemplate.h"
@@ -32,6 +33,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/Capacity.h"
 #include "CXXABI.h"
+#include "IntConstantBytecode.h"
 #include <map>
 
 using namespace clang;
@@ -237,7 +239,8 @@ ASTContext::ASTContext(LangOptions& LOpts, SourceManager &SM,
     DeclarationNames(*this),
     ExternalSource(0), Listener(0),
     LastSDM(0, 0),
-    UniqueBlockByRefTypeID(0) 
+    UniqueBlockByRefTypeID(0), NumCachedEvaluationsReused(0),
+    CanCacheEvaluations(false), ConstantEvaluatorCache(0)
 {
   if (size_reserve > 0) Types.reserve(size_reserve);
   TUDecl = TranslationUnitDecl::Create(*this);
@@ -345,6 +348,35 @@ void ASTContext::PrintStats() const {
                << NumImplicitDestructors
                << " implicit destructors created\n";
 
+  // Name lookup tables of declaration contexts.
+  unsigned NumLookupTables = 0, NumLookupEntries = 0, NumOverflowLists = 0;
+  size_t LookupBytes = 0;
+  for (StoredDeclsMap *Map = LastSDM.getPointer(); Map;
+       Map = Map->Previous.getPointer()) {
+    ++NumLookupTables;
+    NumLookupEntries += Map->size();
+    LookupBytes += Map->getMemorySize();
+    for (StoredDeclsMap::iterator I = Map->begin(), E = Map->end(); I != E;
+         ++I) {
+      if (I->second.getAsVector()) {
+        ++NumOverflowLists;
+        LookupBytes += I->second.getVectorMemorySize();
+      }
+    }
+  }
+  llvm::errs() << NumLookupTables << " name lookup tables, with "
+               << NumLookupEntries << " names (" << NumOverflowLists
+               << " with several declarations), " << LookupBytes
+               << " bytes\n";
+
+  if (getLangOptions().ConstantEvaluationCache)
+    llvm::errs() << CachedEvaluations.size()
+                 << " constant foldings cached, reused "
+                 << NumCachedEvaluationsReused << " times\n";
+
+  if (getLangOptions().getConstantEvaluator() != LangOptions::CE_Tree)
+    PrintIntConstantProgramStats(*this);
+
   if (ExternalSource.get()) {
     llvm::errs() << "\n";
     ExternalSource->PrintStats();
@@ -6578,6 +6610,8 @@ CXXABI::~CXXABI() {}
 size_t ASTContext::getSideTableAllocatedMemory() const {
   return ASTRecordLayouts.getMemorySize()
     + llvm::capacity_in_bytes(ObjCLayouts)
+    + llvm::capacity_in_bytes(CachedEvaluations)
+    + GetIntConstantProgramCacheSize(*this)
     + llvm::capacity_in_bytes(KeyFunctions)
     + llvm::capacity_in_bytes(ObjCImpls)
     + llvm::capacity_in_bytes(BlockVarCopyInits)
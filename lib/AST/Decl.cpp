@@ -939,6 +939,24 @@ bool NamedDecl::declarationReplaces(NamedDecl *OldD) const {
   return this->getKind() == OldD->getKind();
 }
 
+bool NamedDecl::replacesOnlyPreviousDeclaration(NamedDecl *&Prev) const {
+  if (const FunctionDecl *FD = dyn_cast<FunctionDecl>(this)) {
+    Prev = FD->getPreviousDeclaration();
+    return true;
+  }
+
+  if (const FunctionTemplateDecl *FunctionTemplate
+        = dyn_cast<FunctionTemplateDecl>(this)) {
+    Prev = 0;
+    if (FunctionDecl *PrevFD
+          = FunctionTemplate->getTemplatedDecl()->getPreviousDeclaration())
+      Prev = PrevFD->getDescribedFunctionTemplate();
+    return true;
+  }
+
+  return false;
+}
+
 bool NamedDecl::hasLinkage() const {
   return getLinkage() != NoLinkage;
 }
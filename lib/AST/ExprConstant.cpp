@@ -11,6 +11,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "IntConstantBytecode.h"
 #include "clang/AST/APValue.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/CharUnits.h"
@@ -22,6 +23,8 @@
 #include "clang/Basic/Builtins.h"
 #include "clang/Basic/TargetInfo.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Capacity.h"
+#include "llvm/Support/raw_ostream.h"
 #include <cstring>
 
 using namespace clang;
@@ -2655,8 +2658,37 @@ static bool Evaluate(EvalInfo &Info, const Expr *E) {
 /// we want to.  If this function returns true, it returns the folded constant
 /// in Result.
 bool Expr::Evaluate(EvalResult &Result, const ASTContext &Ctx) const {
+  // Dependent expressions change meaning with each instantiation and
+  // failures may succeed later (e.g. once a variable gets its initializer),
+  // so only successful foldings of non-dependent expressions are cached.
+  bool UseCache = Ctx.canCacheEvaluations() && !isInstantiationDependent();
+  if (UseCache) {
+    if (const ASTContext::CachedEvaluation *Cached
+          = Ctx.getCachedEvaluation(this)) {
+      Ctx.noteCachedEvaluationReused();
+      Result.Val = Cached->Val;
+      Result.HasSideEffects = Cached->HasSideEffects;
+      Result.Diag = Cached->Diag;
+      Result.DiagExpr = Cached->DiagExpr;
+      Result.DiagLoc = Cached->DiagLoc;
+      return true;
+    }
+  }
+
   EvalInfo Info(Ctx, Result);
-  return ::Evaluate(Info, this);
+  if (!::Evaluate(Info, this))
+    return false;
+
+  if (UseCache) {
+    ASTContext::CachedEvaluation Cached;
+    Cached.Val = Result.Val;
+    Cached.HasSideEffects = Result.HasSideEffects;
+    Cached.Diag = Result.Diag;
+    Cached.DiagExpr = Result.DiagExpr;
+    Cached.DiagLoc = Result.DiagLoc;
+    Ctx.setCachedEvaluation(this, Cached);
+  }
+  return true;
 }
 
 bool Expr::EvaluateAsBooleanCondition(bool &Result,
@@ -2668,6 +2700,19 @@ bool Expr::EvaluateAsBooleanCondition(bool &Result,
 }
 
 bool Expr::EvaluateAsInt(APSInt &Result, const ASTContext &Ctx) const {
+  // An integer previously folded by Evaluate is also what EvaluateInteger
+  // would produce.
+  if (Ctx.canCacheEvaluations() && !isInstantiationDependent()) {
+    if (const ASTContext::CachedEvaluation *Cached
+          = Ctx.getCachedEvaluation(this)) {
+      if (Cached->Val.isInt() && !Cached->HasSideEffects) {
+        Ctx.noteCachedEvaluationReused();
+        Result = Cached->Val.getInt();
+        return true;
+      }
+    }
+  }
+
   EvalResult Scratch;
   EvalInfo Info(Ctx, Scratch);
 
@@ -3166,18 +3211,125 @@ static ICEDiag CheckICE(const Expr* E, ASTContext &Ctx) {
   return ICEDiag(2, E->getLocStart());
 }
 
+namespace {
+/// IntConstantProgramCache - The bytecode programs of the integer constant
+/// expressions of finished declarations, kept in
+/// ASTContext::getConstantEvaluatorCache. Sema rewrites expressions in place
+/// while it builds them, so programs of other expressions are not kept.
+struct IntConstantProgramCache {
+  llvm::DenseMap<const Expr *, IntConstantProgram *> Programs;
+  unsigned NumReused;
+
+  IntConstantProgramCache() : NumReused(0) { }
+  ~IntConstantProgramCache() {
+    for (llvm::DenseMap<const Expr *, IntConstantProgram *>::iterator
+           I = Programs.begin(), E = Programs.end(); I != E; ++I)
+      DestroyIntConstantProgram(I->second);
+  }
+};
+}
+
+static void DestroyIntConstantProgramCache(void *Cache) {
+  delete static_cast<IntConstantProgramCache *>(Cache);
+}
+
+static IntConstantProgramCache *
+getIntConstantProgramCache(const ASTContext &Ctx, bool Create) {
+  IntConstantProgramCache *Cache
+    = static_cast<IntConstantProgramCache *>(Ctx.getConstantEvaluatorCache());
+  if (!Cache && Create) {
+    Cache = new IntConstantProgramCache;
+    Ctx.setConstantEvaluatorCache(Cache);
+    const_cast<ASTContext &>(Ctx).AddDeallocation(
+      DestroyIntConstantProgramCache, Cache);
+  }
+  return Cache;
+}
+
+/// findIntConstantProgram - Retrieve the cached program of E, which is only
+/// looked up while the expressions being evaluated are finished.
+static const IntConstantProgram *findIntConstantProgram(const Expr *E,
+                                                        const ASTContext &Ctx) {
+  if (!Ctx.areEvaluatedExprsFinished())
+    return 0;
+  IntConstantProgramCache *Cache = getIntConstantProgramCache(Ctx, false);
+  if (!Cache)
+    return 0;
+  const IntConstantProgram *Program = Cache->Programs.lookup(E);
+  if (Program)
+    ++Cache->NumReused;
+  return Program;
+}
+
+bool clang::EvaluateIntConstantBytecode(const Expr *E, const ASTContext &Ctx,
+                                        APSInt &Result) {
+  if (const IntConstantProgram *Program = findIntConstantProgram(E, Ctx))
+    return RunIntConstantProgram(*Program, Result);
+
+  IntConstantProgram *Program = CompileIntConstantProgram(E, Ctx);
+  bool Succeeded = RunIntConstantProgram(*Program, Result);
+  if (Ctx.areEvaluatedExprsFinished())
+    getIntConstantProgramCache(Ctx, true)->Programs[E] = Program;
+  else
+    DestroyIntConstantProgram(Program);
+  return Succeeded;
+}
+
+void clang::PrintIntConstantProgramStats(const ASTContext &Ctx) {
+  IntConstantProgramCache *Cache = getIntConstantProgramCache(Ctx, false);
+  llvm::errs() << (Cache ? Cache->Programs.size() : 0)
+               << " integer constant programs cached, reused "
+               << (Cache ? Cache->NumReused : 0) << " times\n";
+}
+
+size_t clang::GetIntConstantProgramCacheSize(const ASTContext &Ctx) {
+  IntConstantProgramCache *Cache = getIntConstantProgramCache(Ctx, false);
+  return Cache ? llvm::capacity_in_bytes(Cache->Programs) : 0;
+}
+
 bool Expr::isIntegerConstantExpr(llvm::APSInt &Result, ASTContext &Ctx,
                                  SourceLocation *Loc, bool isEvaluated) const {
+  LangOptions::ConstantEvaluatorKind Evaluator
+    = Ctx.getLangOptions().getConstantEvaluator();
+
+  // Programs are only cached for finished declarations, after CheckICE
+  // accepted the expression, which can no longer change. So a cached
+  // program can be run without checking the expression again.
+  if (Evaluator == LangOptions::CE_Bytecode)
+    if (const IntConstantProgram *Program = findIntConstantProgram(this, Ctx))
+      if (RunIntConstantProgram(*Program, Result))
+        return true;
+
   ICEDiag d = CheckICE(this, Ctx);
   if (d.Val != 0) {
     if (Loc) *Loc = d.Loc;
     return false;
   }
+
+  APSInt BytecodeResult;
+  bool BytecodeSucceeded = false;
+  if (Evaluator != LangOptions::CE_Tree) {
+    BytecodeSucceeded = EvaluateIntConstantBytecode(this, Ctx, BytecodeResult);
+    if (BytecodeSucceeded && Evaluator == LangOptions::CE_Bytecode) {
+      Result = BytecodeResult;
+      return true;
+    }
+  }
+
   EvalResult EvalResult;
   if (!Evaluate(EvalResult, Ctx))
     llvm_unreachable("ICE cannot be evaluated!");
   assert(!EvalResult.HasSideEffects && "ICE with side effects!");
   assert(EvalResult.Val.isInt() && "ICE that isn't integer!");
   Result = EvalResult.Val.getInt();
+
+  if (BytecodeSucceeded && Evaluator == LangOptions::CE_Check &&
+      (BytecodeResult.getBitWidth() != Result.getBitWidth() ||
+       BytecodeResult.isSigned() != Result.isSigned() ||
+       BytecodeResult != Result))
+    Ctx.getDiagnostics().Report(getExprLoc(),
+                                diag::err_constant_evaluator_mismatch)
+      << BytecodeResult.toString(10) << Result.toString(10)
+      << getSourceRange();
   return true;
 }
@@ -43,6 +43,11 @@ ExternalASTSource::GetExternalCXXBaseSpecifiers(uint64_t Offset) {
   return 0;
 }
 
+const ASTRecordLayout *
+ExternalASTSource::GetExternalRecordLayout(const RecordDecl *D) {
+  return 0;
+}
+
 DeclContextLookupResult 
 ExternalASTSource::FindExternalVisibleDeclsByName(const DeclContext *DC,
                                                   DeclarationName Name) {
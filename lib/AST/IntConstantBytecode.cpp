@@ -0,0 +1,462 @@
+//===--- IntConstantBytecode.cpp - Bytecode for integer constants ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements evaluation of integer constant expressions by
+// compiling them to a small stack-machine bytecode. The results must match
+// those of IntExprEvaluator in ExprConstant.cpp exactly; compile with
+// -fconstant-evaluator=check to verify this.
+//
+//===----------------------------------------------------------------------===//
+
+#include "IntConstantBytecode.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "llvm/ADT/APSInt.h"
+#include "llvm/ADT/SmallVector.h"
+
+using namespace clang;
+using llvm::APSInt;
+
+namespace {
+
+/// Opcode - The operations of the stack machine. Unless noted otherwise, an
+/// operation pops its operands and pushes its result.
+enum Opcode {
+  OP_PushConstant,  // Push Constants[Arg].
+  OP_PushLeaf,      // Evaluate Leaves[Arg] with the tree walker, push it.
+  OP_Minus,
+  OP_Not,
+  OP_LNot,          // Logical negation, as a value of Types[Arg].
+  OP_ToBool,        // Comparison with zero, as a value of Types[Arg].
+  OP_IntCast,       // Extension or truncation to Types[Arg].
+  OP_Mul, OP_Div, OP_Rem, OP_Add, OP_Sub, OP_Shl, OP_Shr,
+  OP_And, OP_Xor, OP_Or,
+  OP_LT, OP_GT, OP_LE, OP_GE, OP_EQ, OP_NE, // As a value of Types[Arg].
+  OP_Jump,          // Continue at instruction Arg.
+  OP_JumpIfZero,    // Pop a value, and continue at Arg if it is zero.
+  OP_JumpIfNonZero  // Pop a value, and continue at Arg if it is not zero.
+};
+
+struct Instruction {
+  Opcode Op;
+  unsigned Arg;
+};
+
+/// IntType - The width and signedness of an integer type.
+struct IntType {
+  unsigned Width;
+  bool IsUnsigned;
+};
+
+/// CompileStep - An expression being compiled. Expressions with several
+/// operands are revisited after each operand is compiled; State counts
+/// those visits and Fixups holds the jumps that still need a target.
+struct CompileStep {
+  const Expr *E;
+  unsigned State;
+  unsigned Fixups[2];
+
+  explicit CompileStep(const Expr *E) : E(E), State(0) {}
+};
+
+} // end anonymous namespace
+
+namespace clang {
+
+/// IntConstantProgram - The compiled form of an integer constant expression.
+class IntConstantProgram {
+  const ASTContext &Ctx;
+  SmallVector<Instruction, 32> Code;
+  SmallVector<APSInt, 8> Constants;
+  SmallVector<const Expr *, 8> Leaves;
+  SmallVector<IntType, 4> Types;
+
+public:
+  explicit IntConstantProgram(const ASTContext &Ctx) : Ctx(Ctx) {}
+
+  /// compile - Append the code evaluating the integer expression \p E.
+  void compile(const Expr *E);
+
+  /// run - Interpret the program, returning false if some subexpression
+  /// could not be evaluated.
+  bool run(APSInt &Result) const;
+
+private:
+  bool evaluateLeaf(const Expr *E, APSInt &Result) const;
+
+  unsigned emit(Opcode Op, unsigned Arg = 0) {
+    Instruction I = { Op, Arg };
+    Code.push_back(I);
+    return Code.size() - 1;
+  }
+
+  void emitConstant(const APSInt &Value) {
+    Constants.push_back(Value);
+    emit(OP_PushConstant, Constants.size() - 1);
+  }
+
+  void emitLeaf(const Expr *E) {
+    Leaves.push_back(E);
+    emit(OP_PushLeaf, Leaves.size() - 1);
+  }
+
+  /// patch - Make the jump at \p Jump continue at the next instruction.
+  void patch(unsigned Jump) { Code[Jump].Arg = Code.size(); }
+
+  unsigned getTypeIndex(QualType T);
+
+  static APSInt makeInt(uint64_t Value, const IntType &T) {
+    APSInt Result(T.Width, T.IsUnsigned);
+    Result = Value;
+    return Result;
+  }
+};
+
+} // end namespace clang
+
+static bool isIntegral(const Expr *E) {
+  return E->getType()->isIntegralOrEnumerationType();
+}
+
+unsigned IntConstantProgram::getTypeIndex(QualType T) {
+  IntType Type = { Ctx.getIntWidth(T),
+                   T->isUnsignedIntegerOrEnumerationType() };
+  for (unsigned I = 0, N = Types.size(); I != N; ++I)
+    if (Types[I].Width == Type.Width && Types[I].IsUnsigned == Type.IsUnsigned)
+      return I;
+  Types.push_back(Type);
+  return Types.size() - 1;
+}
+
+static Opcode getBinaryOpcode(BinaryOperatorKind Opc) {
+  switch (Opc) {
+  case BO_Mul: return OP_Mul;
+  case BO_Div: return OP_Div;
+  case BO_Rem: return OP_Rem;
+  case BO_Add: return OP_Add;
+  case BO_Sub: return OP_Sub;
+  case BO_Shl: return OP_Shl;
+  case BO_Shr: return OP_Shr;
+  case BO_And: return OP_And;
+  case BO_Xor: return OP_Xor;
+  case BO_Or:  return OP_Or;
+  case BO_LT:  return OP_LT;
+  case BO_GT:  return OP_GT;
+  case BO_LE:  return OP_LE;
+  case BO_GE:  return OP_GE;
+  case BO_EQ:  return OP_EQ;
+  case BO_NE:  return OP_NE;
+  default:
+    llvm_unreachable("not an arithmetic or comparison operator");
+  }
+}
+
+void IntConstantProgram::compile(const Expr *Root) {
+  // The expression is walked with an explicit stack, so deeply nested
+  // expressions don't exhaust the native one.
+  SmallVector<CompileStep, 16> Steps;
+  Steps.push_back(CompileStep(Root));
+
+  while (!Steps.empty()) {
+    CompileStep &Step = Steps.back();
+    const Expr *E = Step.E;
+
+    if (const ParenExpr *PE = dyn_cast<ParenExpr>(E)) {
+      Step.E = PE->getSubExpr();
+      continue;
+    }
+
+    if (const IntegerLiteral *IL = dyn_cast<IntegerLiteral>(E)) {
+      APSInt Value(IL->getValue());
+      Value.setIsUnsigned(E->getType()->isUnsignedIntegerOrEnumerationType());
+      emitConstant(Value);
+      Steps.pop_back();
+      continue;
+    }
+
+    if (const CharacterLiteral *CL = dyn_cast<CharacterLiteral>(E)) {
+      emitConstant(Ctx.MakeIntValue(CL->getValue(), E->getType()));
+      Steps.pop_back();
+      continue;
+    }
+
+    if (const UnaryOperator *UO = dyn_cast<UnaryOperator>(E)) {
+      const Expr *Sub = UO->getSubExpr();
+      UnaryOperatorKind Opc = UO->getOpcode();
+      if ((Opc == UO_Plus || Opc == UO_Extension) && isIntegral(Sub)) {
+        Step.E = Sub;
+        continue;
+      }
+      if ((Opc == UO_Minus || Opc == UO_Not || Opc == UO_LNot) &&
+          isIntegral(Sub)) {
+        if (Step.State == 0) {
+          Step.State = 1;
+          Steps.push_back(CompileStep(Sub));
+          continue;
+        }
+        if (Opc == UO_LNot)
+          emit(OP_LNot, getTypeIndex(E->getType()));
+        else
+          emit(Opc == UO_Minus ? OP_Minus : OP_Not);
+        Steps.pop_back();
+        continue;
+      }
+    }
+
+    if (const CastExpr *CE = dyn_cast<CastExpr>(E)) {
+      const Expr *Sub = CE->getSubExpr();
+      CastKind Kind = CE->getCastKind();
+      if (Kind == CK_NoOp && isIntegral(Sub)) {
+        Step.E = Sub;
+        continue;
+      }
+      if ((Kind == CK_IntegralCast || Kind == CK_IntegralToBoolean) &&
+          isIntegral(Sub)) {
+        if (Step.State == 0) {
+          Step.State = 1;
+          Steps.push_back(CompileStep(Sub));
+          continue;
+        }
+        emit(Kind == CK_IntegralCast ? OP_IntCast : OP_ToBool,
+             getTypeIndex(E->getType()));
+        Steps.pop_back();
+        continue;
+      }
+    }
+
+    if (const BinaryOperator *BO = dyn_cast<BinaryOperator>(E)) {
+      const Expr *LHS = BO->getLHS(), *RHS = BO->getRHS();
+      BinaryOperatorKind Opc = BO->getOpcode();
+      if (isIntegral(LHS) && isIntegral(RHS)) {
+        if (Opc == BO_LAnd || Opc == BO_LOr) {
+          // Short-circuit to the value that an operand equal to zero (for
+          // &&) or not equal to zero (for ||) produces.
+          Opcode ShortCircuit = Opc == BO_LAnd ? OP_JumpIfZero
+                                               : OP_JumpIfNonZero;
+          IntType Type = Types[getTypeIndex(E->getType())];
+          switch (Step.State) {
+          case 0:
+            Step.State = 1;
+            Steps.push_back(CompileStep(LHS));
+            continue;
+          case 1:
+            Step.Fixups[0] = emit(ShortCircuit);
+            Step.State = 2;
+            Steps.push_back(CompileStep(RHS));
+            continue;
+          default: {
+            Step.Fixups[1] = emit(ShortCircuit);
+            emitConstant(makeInt(Opc == BO_LAnd, Type));
+            unsigned End = emit(OP_Jump);
+            patch(Step.Fixups[0]);
+            patch(Step.Fixups[1]);
+            emitConstant(makeInt(Opc == BO_LOr, Type));
+            patch(End);
+            Steps.pop_back();
+            continue;
+          }
+          }
+        }
+
+        if ((BO->isMultiplicativeOp() || BO->isAdditiveOp() ||
+             BO->isShiftOp() || BO->isBitwiseOp() || BO->isComparisonOp())) {
+          switch (Step.State) {
+          case 0:
+            Step.State = 1;
+            Steps.push_back(CompileStep(LHS));
+            continue;
+          case 1:
+            Step.State = 2;
+            Steps.push_back(CompileStep(RHS));
+            continue;
+          default:
+            emit(getBinaryOpcode(Opc),
+                 BO->isComparisonOp() ? getTypeIndex(E->getType()) : 0);
+            Steps.pop_back();
+            continue;
+          }
+        }
+      }
+    }
+
+    if (const ConditionalOperator *CO = dyn_cast<ConditionalOperator>(E)) {
+      if (isIntegral(CO->getCond()) && isIntegral(CO->getTrueExpr()) &&
+          isIntegral(CO->getFalseExpr())) {
+        switch (Step.State) {
+        case 0:
+          Step.State = 1;
+          Steps.push_back(CompileStep(CO->getCond()));
+          continue;
+        case 1:
+          Step.Fixups[0] = emit(OP_JumpIfZero);
+          Step.State = 2;
+          Steps.push_back(CompileStep(CO->getTrueExpr()));
+          continue;
+        case 2:
+          Step.Fixups[1] = emit(OP_Jump);
+          patch(Step.Fixups[0]);
+          Step.State = 3;
+          Steps.push_back(CompileStep(CO->getFalseExpr()));
+          continue;
+        default:
+          patch(Step.Fixups[1]);
+          Steps.pop_back();
+          continue;
+        }
+      }
+    }
+
+    // Anything else is left to the tree walker.
+    emitLeaf(E);
+    Steps.pop_back();
+  }
+}
+
+/// evaluateLeaf - Evaluate a subexpression that is not part of the program.
+/// A load of a constant variable runs the bytecode of the variable's
+/// initializer; anything else is left to the tree walker.
+bool IntConstantProgram::evaluateLeaf(const Expr *E, APSInt &Result) const {
+  const Expr *Ref = E->IgnoreParens();
+  if (const ImplicitCastExpr *ICE = dyn_cast<ImplicitCastExpr>(Ref))
+    if (ICE->getCastKind() == CK_LValueToRValue)
+      Ref = ICE->getSubExpr()->IgnoreParens();
+
+  if (const DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(Ref)) {
+    if (const VarDecl *VD = dyn_cast<VarDecl>(DRE->getDecl())) {
+      // CheckICE has already verified that the initializer is an ICE when
+      // it accepted this reference.
+      const VarDecl *ID = 0;
+      const Expr *Init = VD->getAnyInitializer(ID);
+      if (Init && ID->isInitKnownICE() && ID->isInitICE() &&
+          Init->getType()->getCanonicalTypeUnqualified() ==
+            E->getType()->getCanonicalTypeUnqualified())
+        return EvaluateIntConstantBytecode(Init, Ctx, Result);
+    }
+  }
+
+  return E->EvaluateAsInt(Result, Ctx);
+}
+
+/// Shift - Shift \p LHS by \p RHS, treating a negative shift amount as a
+/// shift in the opposite direction, as IntExprEvaluator does.
+static APSInt Shift(const APSInt &LHS, APSInt RHS, bool Left) {
+  if (RHS.isSigned() && RHS.isNegative()) {
+    RHS = -RHS;
+    Left = !Left;
+  }
+  unsigned SA = (unsigned) RHS.getLimitedValue(LHS.getBitWidth()-1);
+  return Left ? LHS << SA : LHS >> SA;
+}
+
+bool IntConstantProgram::run(APSInt &Result) const {
+  SmallVector<APSInt, 16> Stack;
+
+  for (unsigned PC = 0, N = Code.size(); PC != N; ) {
+    const Instruction &I = Code[PC++];
+    switch (I.Op) {
+    case OP_PushConstant:
+      Stack.push_back(Constants[I.Arg]);
+      continue;
+
+    case OP_PushLeaf: {
+      APSInt Value;
+      if (!evaluateLeaf(Leaves[I.Arg], Value))
+        return false;
+      Stack.push_back(Value);
+      continue;
+    }
+
+    case OP_Minus:
+      Stack.back() = -Stack.back();
+      continue;
+    case OP_Not:
+      Stack.back() = ~Stack.back();
+      continue;
+    case OP_LNot:
+      Stack.back() = makeInt(Stack.back() == 0, Types[I.Arg]);
+      continue;
+    case OP_ToBool:
+      Stack.back() = makeInt(Stack.back() != 0, Types[I.Arg]);
+      continue;
+    case OP_IntCast: {
+      APSInt &Value = Stack.back();
+      Value = Value.extOrTrunc(Types[I.Arg].Width);
+      Value.setIsUnsigned(Types[I.Arg].IsUnsigned);
+      continue;
+    }
+
+    case OP_Jump:
+      PC = I.Arg;
+      continue;
+    case OP_JumpIfZero:
+    case OP_JumpIfNonZero: {
+      bool IsZero = Stack.back() == 0;
+      Stack.pop_back();
+      if (IsZero == (I.Op == OP_JumpIfZero))
+        PC = I.Arg;
+      continue;
+    }
+
+    default:
+      break;
+    }
+
+    // The remaining operations are binary.
+    APSInt RHS = Stack.pop_back_val();
+    APSInt &LHS = Stack.back();
+    switch (I.Op) {
+    case OP_Mul: LHS = LHS * RHS; break;
+    case OP_Add: LHS = LHS + RHS; break;
+    case OP_Sub: LHS = LHS - RHS; break;
+    case OP_And: LHS = LHS & RHS; break;
+    case OP_Xor: LHS = LHS ^ RHS; break;
+    case OP_Or:  LHS = LHS | RHS; break;
+    case OP_Div:
+      if (RHS == 0)
+        return false;
+      LHS = LHS / RHS;
+      break;
+    case OP_Rem:
+      if (RHS == 0)
+        return false;
+      LHS = LHS % RHS;
+      break;
+    case OP_Shl: LHS = Shift(LHS, RHS, /*Left=*/true); break;
+    case OP_Shr: LHS = Shift(LHS, RHS, /*Left=*/false); break;
+    case OP_LT: LHS = makeInt(LHS < RHS, Types[I.Arg]); break;
+    case OP_GT: LHS = makeInt(LHS > RHS, Types[I.Arg]); break;
+    case OP_LE: LHS = makeInt(LHS <= RHS, Types[I.Arg]); break;
+    case OP_GE: LHS = makeInt(LHS >= RHS, Types[I.Arg]); break;
+    case OP_EQ: LHS = makeInt(LHS == RHS, Types[I.Arg]); break;
+    case OP_NE: LHS = makeInt(LHS != RHS, Types[I.Arg]); break;
+    default:
+      llvm_unreachable("unhandled bytecode operation");
+    }
+  }
+
+  assert(Stack.size() == 1 && "unbalanced bytecode program");
+  Result = Stack.back();
+  return true;
+}
+
+IntConstantProgram *clang::CompileIntConstantProgram(const Expr *E,
+                                                    const ASTContext &Ctx) {
+  IntConstantProgram *Program = new IntConstantProgram(Ctx);
+  Program->compile(E);
+  return Program;
+}
+
+void clang::DestroyIntConstantProgram(IntConstantProgram *Program) {
+  delete Program;
+}
+
+bool clang::RunIntConstantProgram(const IntConstantProgram &Program,
+                                  APSInt &Result) {
+  return Program.run(Result);
+}
@@ -0,0 +1,73 @@
+//===--- IntConstantBytecode.h - Bytecode for integer constants -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares an alternative to the tree-walking evaluator in
+// ExprConstant.cpp for integer constant expressions, which flattens the
+// expression into a stack-machine program and interprets it.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_AST_INTCONSTANTBYTECODE_H
+#define LLVM_CLANG_AST_INTCONSTANTBYTECODE_H
+
+#include <cstddef>
+
+namespace llvm {
+  class APSInt;
+}
+
+namespace clang {
+
+class ASTContext;
+class Expr;
+class IntConstantProgram;
+
+/// \brief Compile the integer constant expression \p E into a bytecode
+/// program.
+///
+/// Operators, casts between integer types and literals are compiled into
+/// the program; any other integral subexpression (references to constants,
+/// sizeof, builtin calls, ...) is a leaf that is evaluated when the
+/// interpreter reaches it. Neither compilation nor interpretation recurses
+/// on the depth of the expression.
+///
+/// \p E must already be known to be an integer constant expression. The
+/// caller owns the program and frees it with DestroyIntConstantProgram.
+IntConstantProgram *CompileIntConstantProgram(const Expr *E,
+                                              const ASTContext &Ctx);
+
+/// \brief Free a program returned by CompileIntConstantProgram.
+void DestroyIntConstantProgram(IntConstantProgram *Program);
+
+/// \brief Interpret \p Program.
+///
+/// \returns true and sets \p Result if evaluation succeeded. Returns false
+/// if some part of the program could not be evaluated, in which case the
+/// caller should fall back to the tree-walking evaluator.
+bool RunIntConstantProgram(const IntConstantProgram &Program,
+                           llvm::APSInt &Result);
+
+/// \brief Evaluate the integer constant expression \p E with bytecode.
+///
+/// Programs of expressions that Sema has finished are cached in \p Ctx and
+/// reused; others are compiled for this evaluation only. Implemented in
+/// ExprConstant.cpp, which owns the cache.
+bool EvaluateIntConstantBytecode(const Expr *E, const ASTContext &Ctx,
+                                 llvm::APSInt &Result);
+
+/// \brief Print statistics about the programs cached in \p Ctx.
+void PrintIntConstantProgramStats(const ASTContext &Ctx);
+
+/// \brief Return the memory used by the program cache of \p Ctx, not
+/// counting the programs themselves.
+size_t GetIntConstantProgramCacheSize(const ASTContext &Ctx);
+
+} // end namespace clang
+
+#endif
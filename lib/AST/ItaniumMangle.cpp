@@ -26,6 +26,7 @@
 #include "clang/Basic/ABI.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/TargetInfo.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -67,15 +68,43 @@ static const NamedDecl *getStructor(const NamedDecl *decl) {
 static const unsigned UnknownArity = ~0U;
 
 class ItaniumMangleContext : public MangleContext {
+public:
+  /// MangledPrefix - The mangling of a prefix that was mangled into an
+  /// empty substitution table, along with the substitution candidates it
+  /// introduced, in sequence order.
+  struct MangledPrefix {
+    std::string Name;
+    SmallVector<uintptr_t, 4> Substitutions;
+  };
+
+private:
   llvm::DenseMap<const TagDecl *, uint64_t> AnonStructIds;
   unsigned Discriminator;
   llvm::DenseMap<const NamedDecl*, unsigned> Uniquifier;
+  llvm::DenseMap<const DeclContext *, MangledPrefix *> MangledPrefixes;
   
 public:
   explicit ItaniumMangleContext(ASTContext &Context,
                                 DiagnosticsEngine &Diags)
     : MangleContext(Context, Diags) { }
 
+  ~ItaniumMangleContext() {
+    llvm::DeleteContainerSeconds(MangledPrefixes);
+  }
+
+  /// getMangledPrefix - Return the earlier mangling of the prefix for
+  /// \p DC, or null if there is none.
+  const MangledPrefix *getMangledPrefix(const DeclContext *DC) const {
+    return MangledPrefixes.lookup(DC);
+  }
+
+  /// setMangledPrefix - Remember the mangling of the prefix for \p DC,
+  /// taking ownership of \p Prefix.
+  void setMangledPrefix(const DeclContext *DC, MangledPrefix *Prefix) {
+    assert(!MangledPrefixes.count(DC) && "prefix already mangled");
+    MangledPrefixes[DC] = Prefix;
+  }
+
   uint64_t getAnonymousStructId(const TagDecl *TD) {
     std::pair<llvm::DenseMap<const TagDecl *,
       uint64_t>::iterator, bool> Result =
@@ -147,6 +176,10 @@ class CXXNameMangler {
   /// SeqID - The next subsitution sequence number.
   unsigned SeqID;
 
+  /// BypassPrefixCache - Whether the next reusable prefix must be mangled
+  /// rather than taken from the context, because it is being cached.
+  bool BypassPrefixCache;
+
   class FunctionTypeDepthState {
     unsigned Bits;
 
@@ -194,7 +227,7 @@ public:
   CXXNameMangler(ItaniumMangleContext &C, raw_ostream &Out_,
                  const NamedDecl *D = 0)
     : Context(C), Out(Out_), Structor(getStructor(D)), StructorType(0),
-      SeqID(0) {
+      SeqID(0), BypassPrefixCache(false) {
     // These can't be mangled without a ctor type or dtor type.
     assert(!D || (!isa<CXXDestructorDecl>(D) &&
                   !isa<CXXConstructorDecl>(D)));
@@ -202,11 +235,11 @@ public:
   CXXNameMangler(ItaniumMangleContext &C, raw_ostream &Out_,
                  const CXXConstructorDecl *D, CXXCtorType Type)
     : Context(C), Out(Out_), Structor(getStructor(D)), StructorType(Type),
-      SeqID(0) { }
+      SeqID(0), BypassPrefixCache(false) { }
   CXXNameMangler(ItaniumMangleContext &C, raw_ostream &Out_,
                  const CXXDestructorDecl *D, CXXDtorType Type)
     : Context(C), Out(Out_), Structor(getStructor(D)), StructorType(Type),
-      SeqID(0) { }
+      SeqID(0), BypassPrefixCache(false) { }
 
 #if MANGLE_CHECKER
   ~CXXNameMangler() {
@@ -279,6 +312,7 @@ private:
                         unsigned NumTemplateArgs);
   void manglePrefix(NestedNameSpecifier *qualifier);
   void manglePrefix(const DeclContext *DC, bool NoFunction=false);
+  void mangleReusablePrefix(const DeclContext *DC);
   void manglePrefix(QualType type);
   void mangleTemplatePrefix(const TemplateDecl *ND);
   void mangleTemplatePrefix(TemplateName Template);
@@ -1251,6 +1285,56 @@ void CXXNameMangler::manglePrefix(NestedNameSpecifier *qualifier) {
   llvm_unreachable("unexpected nested name specifier");
 }
 
+/// isReusablePrefix - Determine whether the prefix for \p DC, when it is
+/// the first thing mangled into a name, always mangles the same way. This
+/// holds when it is made of namespaces and non-dependent classes only: local
+/// and block scopes depend on discriminators, and dependent contexts on the
+/// template parameters in scope.
+static bool isReusablePrefix(const DeclContext *DC) {
+  if (DC->isDependentContext())
+    return false;
+
+  for (; !DC->isTranslationUnit(); DC = DC->getParent())
+    if (!isa<NamespaceDecl>(DC) && !isa<LinkageSpecDecl>(DC) &&
+        !isa<CXXRecordDecl>(DC))
+      return false;
+  return true;
+}
+
+/// mangleReusablePrefix - Mangle the prefix for \p DC into an empty
+/// substitution table, replaying an earlier mangling of it if possible.
+/// Template-heavy code repeats long prefixes (nested namespaces, class
+/// template specializations with their argument lists) for every member.
+void CXXNameMangler::mangleReusablePrefix(const DeclContext *DC) {
+  assert(Substitutions.empty() && "prefix depends on earlier substitutions");
+
+  const ItaniumMangleContext::MangledPrefix *Prefix
+    = Context.getMangledPrefix(DC);
+  if (!Prefix) {
+    llvm::SmallString<64> Name;
+    llvm::raw_svector_ostream NameStream(Name);
+    CXXNameMangler Mangler(Context, NameStream);
+    Mangler.BypassPrefixCache = true;
+    Mangler.manglePrefix(DC);
+    NameStream.flush();
+
+    ItaniumMangleContext::MangledPrefix *NewPrefix
+      = new ItaniumMangleContext::MangledPrefix;
+    NewPrefix->Name = Name.str();
+    NewPrefix->Substitutions.resize(Mangler.Substitutions.size());
+    for (llvm::DenseMap<uintptr_t, unsigned>::iterator
+           I = Mangler.Substitutions.begin(), E = Mangler.Substitutions.end();
+         I != E; ++I)
+      NewPrefix->Substitutions[I->second] = I->first;
+    Context.setMangledPrefix(DC, NewPrefix);
+    Prefix = NewPrefix;
+  }
+
+  Out << Prefix->Name;
+  for (unsigned I = 0, N = Prefix->Substitutions.size(); I != N; ++I)
+    addSubstitution(Prefix->Substitutions[I]);
+}
+
 void CXXNameMangler::manglePrefix(const DeclContext *DC, bool NoFunction) {
   //  <prefix> ::= <prefix> <unqualified-name>
   //           ::= <template-prefix> <template-args>
@@ -1264,6 +1348,14 @@ void CXXNameMangler::manglePrefix(const DeclContext *DC, bool NoFunction) {
   if (DC->isTranslationUnit())
     return;
 
+  if (Substitutions.empty() && isReusablePrefix(DC)) {
+    if (!BypassPrefixCache) {
+      mangleReusablePrefix(DC);
+      return;
+    }
+    BypassPrefixCache = false;
+  }
+
   if (const BlockDecl *Block = dyn_cast<BlockDecl>(DC)) {
     manglePrefix(DC->getParent(), NoFunction);    
     llvm::SmallString<64> Name;
@@ -12,6 +12,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "clang/AST/ASTContext.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclObjC.h"
 #include "clang/AST/DeclTemplate.h"
@@ -25,6 +26,7 @@
 #include "clang/Analysis/CFGStmtMap.h"
 #include "clang/Analysis/Support/BumpVector.h"
 #include "clang/Analysis/Support/SaveAndRestore.h"
+#include "clang/Basic/SourceManager.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/Support/ErrorHandling.h"
 
@@ -40,6 +42,7 @@ AnalysisContext::AnalysisContext(const Decl *d,
     forcedBlkExprs(0),
     builtCFG(false),
     builtCompleteCFG(false),
+    denseLivenessLimit(DefaultDenseLivenessLimit),
     ReferencedBlockVars(0),
     ManagedAnalyses(0)
 {  
@@ -52,6 +55,7 @@ AnalysisContext::AnalysisContext(const Decl *d,
   forcedBlkExprs(0),
   builtCFG(false),
   builtCompleteCFG(false),
+  denseLivenessLimit(DefaultDenseLivenessLimit),
   ReferencedBlockVars(0),
   ManagedAnalyses(0)
 {  
@@ -60,10 +64,14 @@ AnalysisContext::AnalysisContext(const Decl *d,
 
 AnalysisContextManager::AnalysisContextManager(bool useUnoptimizedCFG,
                                                bool addImplicitDtors,
-                                               bool addInitializers) {
+                                               bool addInitializers)
+  : denseLivenessLimit(AnalysisContext::DefaultDenseLivenessLimit),
+    shareMainFileOnly(false), NumSharedContexts(0),
+    NumSharedContextsReused(0) {
   cfgBuildOptions.PruneTriviallyFalseEdges = !useUnoptimizedCFG;
   cfgBuildOptions.AddImplicitDtors = addImplicitDtors;
   cfgBuildOptions.AddInitializers = addInitializers;
+  cfgBuildOptions.ScratchAllocator = &cfgScratch;
 }
 
 void AnalysisContextManager::clear() {
@@ -183,8 +191,49 @@ PseudoConstantAnalysis *AnalysisContext::getPseudoConstantAnalysis() {
 AnalysisContext *AnalysisContextManager::getContext(const Decl *D,
                                                     idx::TranslationUnit *TU) {
   AnalysisContext *&AC = Contexts[D];
-  if (!AC)
-    AC = new AnalysisContext(D, TU, cfgBuildOptions);
+  if (!AC) {
+    ContextMap::iterator I = SharedContexts.find(D);
+    if (I != SharedContexts.end() && I->second->getTranslationUnit() == TU) {
+      AC = I->second;
+      SharedContexts.erase(I);
+      if (AC->isCFGBuilt())
+        ++NumSharedContextsReused;
+    } else {
+      AC = new AnalysisContext(D, TU, cfgBuildOptions);
+      AC->setDenseLivenessLimit(denseLivenessLimit);
+    }
+  }
+  return AC;
+}
+
+AnalysisContext *
+AnalysisContextManager::getSharedContext(const Decl *D,
+                                         const CFG::BuildOptions &Options) {
+  // Our CFG can stand in for the requested one if it has the same shape and
+  // contains at least the statements the client wants as CFGElements.  The
+  // initializer and implicit destructor elements only exist in C++.
+  const ASTContext &Ctx = D->getASTContext();
+  bool CPlusPlus = Ctx.getLangOptions().CPlusPlus;
+  if (Options.PruneTriviallyFalseEdges !=
+        cfgBuildOptions.PruneTriviallyFalseEdges ||
+      Options.AddEHEdges != cfgBuildOptions.AddEHEdges ||
+      (CPlusPlus &&
+       (Options.AddInitializers != cfgBuildOptions.AddInitializers ||
+        Options.AddImplicitDtors != cfgBuildOptions.AddImplicitDtors)) ||
+      !cfgBuildOptions.alwaysAddsAllOf(Options))
+    return 0;
+
+  if (shareMainFileOnly) {
+    const SourceManager &SM = Ctx.getSourceManager();
+    if (!SM.isFromMainFile(SM.getExpansionLoc(D->getLocation())))
+      return 0;
+  }
+
+  AnalysisContext *&AC = SharedContexts[D];
+  delete AC;
+  AC = new AnalysisContext(D, 0, cfgBuildOptions);
+  AC->setDenseLivenessLimit(denseLivenessLimit);
+  ++NumSharedContexts;
   return AC;
 }
 
@@ -415,6 +464,9 @@ AnalysisContext::~AnalysisContext() {
 AnalysisContextManager::~AnalysisContextManager() {
   for (ContextMap::iterator I = Contexts.begin(), E = Contexts.end(); I!=E; ++I)
     delete I->second;
+  for (ContextMap::iterator I = SharedContexts.begin(),
+       E = SharedContexts.end(); I != E; ++I)
+    delete I->second;
 }
 
 LocationContext::~LocationContext() {}
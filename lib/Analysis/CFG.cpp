@@ -250,6 +250,14 @@ class CFGBuilder {
   typedef BlockScopePosPair JumpSource;
 
   ASTContext *Context;
+
+  // The blocks' lists and the local scopes are grown in a scratch allocator,
+  // and the lists are moved into the CFG by CFG::compact() when it is done.
+  // This leaves the memory lost to growing the lists behind.
+  llvm::OwningPtr<llvm::BumpPtrAllocator> OwnedScratch;
+  llvm::BumpPtrAllocator &ScratchAlloc;
+  BumpVectorContext Scratch;
+
   llvm::OwningPtr<CFG> cfg;
 
   CFGBlock *Block;
@@ -289,13 +297,27 @@ class CFGBuilder {
 public:
   explicit CFGBuilder(ASTContext *astContext,
                       const CFG::BuildOptions &buildOpts) 
-    : Context(astContext), cfg(new CFG()), // crew a new CFG
+    : Context(astContext),
+      OwnedScratch(buildOpts.ScratchAllocator ? 0
+                                              : new llvm::BumpPtrAllocator()),
+      ScratchAlloc(buildOpts.ScratchAllocator ? *buildOpts.ScratchAllocator
+                                              : *OwnedScratch),
+      Scratch(ScratchAlloc),
+      cfg(new CFG()), // crew a new CFG
       Block(NULL), Succ(NULL),
       SwitchTerminatedBlock(NULL), DefaultCaseBlock(NULL),
       TryTerminatedBlock(NULL), badCFG(false), BuildOpts(buildOpts), 
       switchExclusivelyCovered(false), switchCond(0),
       cachedEntry(0), lastLookup(0) {}
 
+  ~CFGBuilder() {
+    // Let go of a CFG we failed to build before its lists go away, and
+    // hand the scratch memory back for the next build.
+    cfg.reset();
+    if (!OwnedScratch)
+      ScratchAlloc.Reset();
+  }
+
   // buildCFG - Used by external clients to construct the CFG.
   CFG* buildCFG(const Decl *D, Stmt *Statement);
 
@@ -400,29 +422,29 @@ private:
 
     // All block-level expressions should have already been IgnoreParens()ed.
     assert(!isa<Expr>(S) || cast<Expr>(S)->IgnoreParens() == S);
-    B->appendStmt(const_cast<Stmt*>(S), cfg->getBumpVectorContext());
+    B->appendStmt(const_cast<Stmt*>(S), Scratch);
   }
   void appendInitializer(CFGBlock *B, CXXCtorInitializer *I) {
-    B->appendInitializer(I, cfg->getBumpVectorContext());
+    B->appendInitializer(I, Scratch);
   }
   void appendBaseDtor(CFGBlock *B, const CXXBaseSpecifier *BS) {
-    B->appendBaseDtor(BS, cfg->getBumpVectorContext());
+    B->appendBaseDtor(BS, Scratch);
   }
   void appendMemberDtor(CFGBlock *B, FieldDecl *FD) {
-    B->appendMemberDtor(FD, cfg->getBumpVectorContext());
+    B->appendMemberDtor(FD, Scratch);
   }
   void appendTemporaryDtor(CFGBlock *B, CXXBindTemporaryExpr *E) {
-    B->appendTemporaryDtor(E, cfg->getBumpVectorContext());
+    B->appendTemporaryDtor(E, Scratch);
   }
   void appendAutomaticObjDtor(CFGBlock *B, VarDecl *VD, Stmt *S) {
-    B->appendAutomaticObjDtor(VD, S, cfg->getBumpVectorContext());
+    B->appendAutomaticObjDtor(VD, S, Scratch);
   }
 
   void prependAutomaticObjDtorsWithTerminator(CFGBlock *Blk,
       LocalScope::const_iterator B, LocalScope::const_iterator E);
 
   void addSuccessor(CFGBlock *B, CFGBlock *S) {
-    B->addSuccessor(S, cfg->getBumpVectorContext());
+    B->addSuccessor(S, Scratch);
   }
 
   /// Try and evaluate an expression to an integer constant.
@@ -578,13 +600,14 @@ CFG* CFGBuilder::buildCFG(const Decl *D, Stmt *Statement) {
   // Create an empty entry block that has no predecessors.
   cfg->setEntry(createBlock());
 
+  cfg->compact();
   return cfg.take();
 }
 
 /// createBlock - Used to lazily create blocks that are connected
 ///  to the current (global) succcessor.
 CFGBlock *CFGBuilder::createBlock(bool add_successor) {
-  CFGBlock *B = cfg->createBlock();
+  CFGBlock *B = cfg->createBlock(Scratch);
   if (add_successor && Succ)
     addSuccessor(B, Succ);
   return B;
@@ -731,10 +754,8 @@ void CFGBuilder::addImplicitDtorsForDestructor(const CXXDestructorDecl *DD) {
 /// way return valid LocalScope object.
 LocalScope* CFGBuilder::createOrReuseLocalScope(LocalScope* Scope) {
   if (!Scope) {
-    llvm::BumpPtrAllocator &alloc = cfg->getAllocator();
-    Scope = alloc.Allocate<LocalScope>();
-    BumpVectorContext ctx(alloc);
-    new (Scope) LocalScope(ctx, ScopePos);
+    Scope = ScratchAlloc.Allocate<LocalScope>();
+    new (Scope) LocalScope(Scratch, ScopePos);
   }
   return Scope;
 }
@@ -844,7 +865,7 @@ void CFGBuilder::addLocalScopeAndDtors(Stmt *S) {
 /// no-return destructors properly.
 void CFGBuilder::prependAutomaticObjDtorsWithTerminator(CFGBlock *Blk,
     LocalScope::const_iterator B, LocalScope::const_iterator E) {
-  BumpVectorContext &C = cfg->getBumpVectorContext();
+  BumpVectorContext &C = Scratch;
   CFGBlock::iterator InsertPos
     = Blk->beginAutomaticObjDtorsInsert(Blk->end(), B.distance(E), C);
   for (LocalScope::const_iterator I = B; I != E; ++I)
@@ -2953,13 +2974,13 @@ CFGBlock *CFGBuilder::VisitConditionalOperatorForTemporaryDtors(
 /// createBlock - Constructs and adds a new CFGBlock to the CFG.  The block has
 ///  no successors or predecessors.  If this is the first block created in the
 ///  CFG, it is automatically set to be the Entry and Exit of the CFG.
-CFGBlock *CFG::createBlock() {
+CFGBlock *CFG::createBlock(BumpVectorContext &C) {
   bool first_block = begin() == end();
 
   // Create the block.
   CFGBlock *Mem = getAllocator().Allocate<CFGBlock>();
-  new (Mem) CFGBlock(NumBlockIDs++, BlkBVC);
-  Blocks.push_back(Mem, BlkBVC);
+  new (Mem) CFGBlock(NumBlockIDs++, C);
+  Blocks.push_back(Mem, C);
 
   // If this is the first block, set it as the Entry and Exit.
   if (first_block)
@@ -2969,6 +2990,28 @@ CFGBlock *CFG::createBlock() {
   return &back();
 }
 
+void CFG::compact() {
+  size_t NumElements = 0, NumAdjacent = 0;
+  for (iterator I = begin(), E = end(); I != E; ++I) {
+    NumElements += (*I)->size();
+    NumAdjacent += (*I)->pred_size() + (*I)->succ_size();
+  }
+
+  llvm::BumpPtrAllocator &A = getAllocator();
+  CFGBlock **BlockStorage = A.Allocate<CFGBlock*>(Blocks.size());
+  CFGElement *Elts = A.Allocate<CFGElement>(NumElements);
+  CFGBlock **Adj = A.Allocate<CFGBlock*>(NumAdjacent);
+
+  for (iterator I = begin(), E = end(); I != E; ++I) {
+    CFGBlock *B = *I;
+    size_t NumElts = B->size(), NumAdj = B->pred_size() + B->succ_size();
+    B->relocate(Elts, Adj);
+    Elts += NumElts;
+    Adj += NumAdj;
+  }
+  Blocks.relocate(BlockStorage);
+}
+
 /// buildCFG - Constructs a CFG from an AST.  Ownership of the returned
 ///  CFG is returned to the caller.
 CFG* CFG::buildCFG(const Decl *D, Stmt *Statement, ASTContext *C,
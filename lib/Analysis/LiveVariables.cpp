@@ -6,6 +6,7 @@
 
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/OwningPtr.h"
 
 #include <deque>
 #include <algorithm>
@@ -181,6 +182,42 @@ const CFGBlock *DataflowWorklist::dequeue() {
   return b;
 }
 
+class LiveVariables::DenseNumbering {
+  llvm::DenseMap<const Stmt *, unsigned> StmtIDs;
+  llvm::DenseMap<const VarDecl *, unsigned> DeclIDs;
+  std::vector<const VarDecl *> Decls;
+
+public:
+  unsigned getNumStmts() const { return StmtIDs.size(); }
+  unsigned getNumDecls() const { return Decls.size(); }
+  const VarDecl *getDecl(unsigned ID) const { return Decls[ID]; }
+
+  /// Return the ID of \p S, numbering it if it has not been seen yet.
+  unsigned getID(const Stmt *S) {
+    return StmtIDs.insert(std::make_pair(S, getNumStmts())).first->second;
+  }
+
+  /// Return the ID of \p D, numbering it if it has not been seen yet.
+  unsigned getID(const VarDecl *D) {
+    std::pair<llvm::DenseMap<const VarDecl *, unsigned>::iterator, bool>
+      Res = DeclIDs.insert(std::make_pair(D, getNumDecls()));
+    if (Res.second)
+      Decls.push_back(D);
+    return Res.first->second;
+  }
+
+  bool test(const llvm::BitVector &Bits, const Stmt *S) const {
+    llvm::DenseMap<const Stmt *, unsigned>::const_iterator I = StmtIDs.find(S);
+    return I != StmtIDs.end() && I->second < Bits.size() && Bits[I->second];
+  }
+
+  bool test(const llvm::BitVector &Bits, const VarDecl *D) const {
+    llvm::DenseMap<const VarDecl *, unsigned>::const_iterator
+      I = DeclIDs.find(D);
+    return I != DeclIDs.end() && I->second < Bits.size() && Bits[I->second];
+  }
+};
+
 namespace {
 class LiveVariablesImpl {
 public:  
@@ -193,10 +230,20 @@ public:
   llvm::DenseMap<const Stmt *, LiveVariables::LivenessValues> stmtsToLiveness;
   llvm::DenseMap<const DeclRefExpr *, unsigned> inAssignment;
   const bool killAtAssign;
+
+  /// Non-null if the liveness sets are bit vectors rather than
+  /// ImmutableSets.
+  llvm::OwningPtr<LiveVariables::DenseNumbering> numbering;
   
   LiveVariables::LivenessValues
   merge(LiveVariables::LivenessValues valsA,
         LiveVariables::LivenessValues valsB);
+
+  void add(LiveVariables::LivenessValues &val, const Stmt *S);
+  void add(LiveVariables::LivenessValues &val, const VarDecl *D);
+  void remove(LiveVariables::LivenessValues &val, const Stmt *S);
+  void remove(LiveVariables::LivenessValues &val, const VarDecl *D);
+  void normalize(LiveVariables::LivenessValues &val);
       
   LiveVariables::LivenessValues runOnBlock(const CFGBlock *block,
                                            LiveVariables::LivenessValues val,
@@ -221,13 +268,71 @@ static LiveVariablesImpl &getImpl(void *x) {
 //===----------------------------------------------------------------------===//
 
 bool LiveVariables::LivenessValues::isLive(const Stmt *S) const {
+  if (numbering)
+    return numbering->test(liveStmtBits, S);
   return liveStmts.contains(S);
 }
 
 bool LiveVariables::LivenessValues::isLive(const VarDecl *D) const {
+  if (numbering)
+    return numbering->test(liveDeclBits, D);
   return liveDecls.contains(D);
 }
 
+/// Grow the bit vectors of a dense value to cover everything numbered so
+/// far, so that values can be combined with plain bitwise operations.
+void LiveVariablesImpl::normalize(LiveVariables::LivenessValues &val) {
+  val.numbering = numbering.get();
+  if (val.liveStmtBits.size() < numbering->getNumStmts())
+    val.liveStmtBits.resize(numbering->getNumStmts());
+  if (val.liveDeclBits.size() < numbering->getNumDecls())
+    val.liveDeclBits.resize(numbering->getNumDecls());
+}
+
+void LiveVariablesImpl::add(LiveVariables::LivenessValues &val,
+                            const Stmt *S) {
+  if (!numbering) {
+    val.liveStmts = SSetFact.add(val.liveStmts, S);
+    return;
+  }
+  unsigned ID = numbering->getID(S);
+  normalize(val);
+  val.liveStmtBits.set(ID);
+}
+
+void LiveVariablesImpl::add(LiveVariables::LivenessValues &val,
+                            const VarDecl *D) {
+  if (!numbering) {
+    val.liveDecls = DSetFact.add(val.liveDecls, D);
+    return;
+  }
+  unsigned ID = numbering->getID(D);
+  normalize(val);
+  val.liveDeclBits.set(ID);
+}
+
+void LiveVariablesImpl::remove(LiveVariables::LivenessValues &val,
+                               const Stmt *S) {
+  if (!numbering) {
+    val.liveStmts = SSetFact.remove(val.liveStmts, S);
+    return;
+  }
+  unsigned ID = numbering->getID(S);
+  if (ID < val.liveStmtBits.size())
+    val.liveStmtBits.reset(ID);
+}
+
+void LiveVariablesImpl::remove(LiveVariables::LivenessValues &val,
+                               const VarDecl *D) {
+  if (!numbering) {
+    val.liveDecls = DSetFact.remove(val.liveDecls, D);
+    return;
+  }
+  unsigned ID = numbering->getID(D);
+  if (ID < val.liveDeclBits.size())
+    val.liveDeclBits.reset(ID);
+}
+
 namespace {
   template <typename SET>
   SET mergeSets(SET A, SET B) {
@@ -244,6 +349,13 @@ namespace {
 LiveVariables::LivenessValues
 LiveVariablesImpl::merge(LiveVariables::LivenessValues valsA,
                          LiveVariables::LivenessValues valsB) {  
+  if (numbering) {
+    normalize(valsA);
+    normalize(valsB);
+    valsA.liveStmtBits |= valsB.liveStmtBits;
+    valsA.liveDeclBits |= valsB.liveDeclBits;
+    return valsA;
+  }
   
   llvm::ImmutableSetRef<const Stmt *>
     SSetRefA(valsA.liveStmts.getRootWithoutRetain(), SSetFact.getTreeFactory()),
@@ -264,7 +376,23 @@ LiveVariablesImpl::merge(LiveVariables::LivenessValues valsA,
                                        DSetRefA.asImmutableSet());  
 }
 
+/// Compare two bit vectors, treating bits past the end of the shorter one
+/// as clear.
+static bool bitsEqual(const llvm::BitVector &A, const llvm::BitVector &B) {
+  if (A.size() == B.size())
+    return A == B;
+  const llvm::BitVector &Short = A.size() < B.size() ? A : B;
+  const llvm::BitVector &Long = A.size() < B.size() ? B : A;
+  for (unsigned I = 0, E = Long.size(); I != E; ++I)
+    if (Long[I] != (I < Short.size() && Short[I]))
+      return false;
+  return true;
+}
+
 bool LiveVariables::LivenessValues::equals(const LivenessValues &V) const {
+  if (numbering || V.numbering)
+    return bitsEqual(liveStmtBits, V.liveStmtBits) &&
+           bitsEqual(liveDeclBits, V.liveDeclBits);
   return liveStmts == V.liveStmts && liveDecls == V.liveDecls;
 }
 
@@ -336,7 +464,7 @@ void TransferFunctions::Visit(Stmt *S) {
   StmtVisitor<TransferFunctions>::Visit(S);
   
   if (isa<Expr>(S)) {
-    val.liveStmts = LV.SSetFact.remove(val.liveStmts, S);
+    LV.remove(val, S);
   }
 
   // Mark all children expressions live.
@@ -354,7 +482,7 @@ void TransferFunctions::Visit(Stmt *S) {
       CXXMemberCallExpr *CE = cast<CXXMemberCallExpr>(S);
       if (Expr *ImplicitObj = CE->getImplicitObjectArgument()) {
         ImplicitObj = ImplicitObj->IgnoreParens();        
-        val.liveStmts = LV.SSetFact.add(val.liveStmts, ImplicitObj);
+        LV.add(val, ImplicitObj);
       }
       break;
     }
@@ -363,8 +491,7 @@ void TransferFunctions::Visit(Stmt *S) {
       if (const VarDecl *VD = dyn_cast<VarDecl>(DS->getSingleDecl())) {
         for (const VariableArrayType* VA = FindVA(VD->getType());
              VA != 0; VA = FindVA(VA->getElementType())) {
-          val.liveStmts = LV.SSetFact.add(val.liveStmts,
-                                          VA->getSizeExpr()->IgnoreParens());
+          LV.add(val, VA->getSizeExpr()->IgnoreParens());
         }
       }
       break;
@@ -390,7 +517,7 @@ void TransferFunctions::Visit(Stmt *S) {
       if (Expr *Ex = dyn_cast<Expr>(child))
         child = Ex->IgnoreParens();
                
-      val.liveStmts = LV.SSetFact.add(val.liveStmts, child);
+      LV.add(val, child);
     }
   }
 }
@@ -411,7 +538,7 @@ void TransferFunctions::VisitBinaryOperator(BinaryOperator *B) {
 
         if (!isAlwaysAlive(VD)) {
           // The variable is now dead.
-          val.liveDecls = LV.DSetFact.remove(val.liveDecls, VD);
+          LV.remove(val, VD);
         }
 
         if (observer)
@@ -428,14 +555,14 @@ void TransferFunctions::VisitBlockExpr(BlockExpr *BE) {
     const VarDecl *VD = *I;
     if (isAlwaysAlive(VD))
       continue;
-    val.liveDecls = LV.DSetFact.add(val.liveDecls, VD);
+    LV.add(val, VD);
   }
 }
 
 void TransferFunctions::VisitDeclRefExpr(DeclRefExpr *DR) {
   if (const VarDecl *D = dyn_cast<VarDecl>(DR->getDecl()))
     if (!isAlwaysAlive(D) && LV.inAssignment.find(DR) == LV.inAssignment.end())
-      val.liveDecls = LV.DSetFact.add(val.liveDecls, D);
+      LV.add(val, D);
 }
 
 void TransferFunctions::VisitDeclStmt(DeclStmt *DS) {
@@ -443,7 +570,7 @@ void TransferFunctions::VisitDeclStmt(DeclStmt *DS) {
        DI != DE; ++DI)
     if (VarDecl *VD = dyn_cast<VarDecl>(*DI)) {
       if (!isAlwaysAlive(VD))
-        val.liveDecls = LV.DSetFact.remove(val.liveDecls, VD);
+        LV.remove(val, VD);
     }
 }
 
@@ -461,7 +588,7 @@ void TransferFunctions::VisitObjCForCollectionStmt(ObjCForCollectionStmt *OS) {
   }
   
   if (VD) {
-    val.liveDecls = LV.DSetFact.remove(val.liveDecls, VD);
+    LV.remove(val, VD);
     if (observer && DR)
       observer->observerKill(DR);
   }
@@ -479,7 +606,7 @@ VisitUnaryExprOrTypeTraitExpr(UnaryExprOrTypeTraitExpr *UE)
   const Expr *subEx = UE->getArgumentExpr();
   if (subEx->getType()->isVariableArrayType()) {
     assert(subEx->isLValue());
-    val.liveStmts = LV.SSetFact.add(val.liveStmts, subEx->IgnoreParens());
+    LV.add(val, subEx->IgnoreParens());
   }
 }
 
@@ -559,11 +686,13 @@ LiveVariables::computeLiveness(AnalysisContext &AC,
   // start of the analysis.
   DataflowWorklist worklist(*cfg);
   llvm::BitVector everAnalyzedBlock(cfg->getNumBlockIDs());
+  unsigned numStmts = 0;
 
   // FIXME: we should enqueue using post order.
   for (CFG::const_iterator it = cfg->begin(), ei = cfg->end(); it != ei; ++it) {
     const CFGBlock *block = *it;
     worklist.enqueueBlock(block);
+    numStmts += block->size();
     
     // FIXME: Scan for DeclRefExprs using in the LHS of an assignment.
     // We need to do this because we lack context in the reverse analysis
@@ -585,6 +714,13 @@ LiveVariables::computeLiveness(AnalysisContext &AC,
       }
   }
   
+  // Bit vectors make merging and comparing values cheap, but every
+  // statement keeps its own copy of the value, so their total size grows
+  // quadratically with the size of the function. Large functions use
+  // ImmutableSets, which share structure between statements.
+  if (numStmts <= AC.getDenseLivenessLimit())
+    LV->numbering.reset(new DenseNumbering());
+
   worklist.sortWorklist();
   
   while (const CFGBlock *block = worklist.dequeue()) {
@@ -651,6 +787,12 @@ void LiveVariablesImpl::dumpBlockLiveness(const SourceManager &M) {
     LiveVariables::LivenessValues vals = blocksEndToLiveness[*it];
     declVec.clear();
     
+    if (vals.numbering) {
+      for (int i = vals.liveDeclBits.find_first(); i != -1;
+           i = vals.liveDeclBits.find_next(i))
+        declVec.push_back(numbering->getDecl(i));
+    }
+
     for (llvm::ImmutableSet<const VarDecl *>::iterator si =
           vals.liveDecls.begin(),
           se = vals.liveDecls.end(); si != se; ++si) {
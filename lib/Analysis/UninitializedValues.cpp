@@ -11,8 +11,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <functional>
 #include <utility>
+#include <vector>
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/PackedVector.h"
 #include "llvm/ADT/DenseMap.h"
@@ -39,31 +43,141 @@ static bool isTrackedVar(const VarDecl *vd, const DeclContext *dc) {
 // DeclToIndex: a mapping from Decls we track to value indices.
 //====------------------------------------------------------------------------//
 
+namespace {
+/// Collects what DeclToIndex needs to know about a function body to leave
+/// out the variables that cannot be read uninitialized.
+class VarUseScanner {
+  const DeclContext &dc;
+public:
+  /// The tracked variables the body refers to or captures in a block.
+  llvm::SmallPtrSet<const VarDecl *, 16> referenced;
+  /// The tracked variables the body declares with an initializer.
+  SmallVector<const VarDecl *, 16> initialized;
+  /// Whether the body contains a statement that can jump past a declaration.
+  bool hasJumps;
+
+  VarUseScanner(const DeclContext &dc) : dc(dc), hasJumps(false) {}
+
+  void scan(const Stmt *s);
+};
+}
+
+void VarUseScanner::scan(const Stmt *s) {
+  switch (s->getStmtClass()) {
+    case Stmt::GotoStmtClass:
+    case Stmt::IndirectGotoStmtClass:
+    case Stmt::SwitchStmtClass:
+      hasJumps = true;
+      break;
+    case Stmt::DeclRefExprClass:
+      if (const VarDecl *vd =
+            dyn_cast<VarDecl>(cast<DeclRefExpr>(s)->getDecl()))
+        if (isTrackedVar(vd, &dc))
+          referenced.insert(vd);
+      break;
+    case Stmt::BlockExprClass: {
+      // The body of a block is not among its children; only its captures
+      // matter here.
+      const BlockDecl *bd = cast<BlockExpr>(s)->getBlockDecl();
+      for (BlockDecl::capture_const_iterator i = bd->capture_begin(),
+           e = bd->capture_end(); i != e; ++i)
+        if (isTrackedVar(i->getVariable(), &dc))
+          referenced.insert(i->getVariable());
+      break;
+    }
+    case Stmt::DeclStmtClass: {
+      const DeclStmt *ds = cast<DeclStmt>(s);
+      for (DeclStmt::const_decl_iterator i = ds->decl_begin(),
+           e = ds->decl_end(); i != e; ++i)
+        if (const VarDecl *vd = dyn_cast<VarDecl>(*i))
+          if (vd->getInit() && isTrackedVar(vd, &dc))
+            initialized.push_back(vd);
+      break;
+    }
+    default:
+      break;
+  }
+
+  for (Stmt::const_child_iterator i = s->child_begin(), e = s->child_end();
+       i != e; ++i)
+    if (*i)
+      scan(*i);
+}
+
+/// Return true if \p s refers to \p vd, directly or by capturing it in a
+/// block.
+static bool refersTo(const Stmt *s, const VarDecl *vd) {
+  if (const DeclRefExpr *dr = dyn_cast<DeclRefExpr>(s))
+    return dr->getDecl() == vd;
+  if (const BlockExpr *be = dyn_cast<BlockExpr>(s)) {
+    const BlockDecl *bd = be->getBlockDecl();
+    for (BlockDecl::capture_const_iterator i = bd->capture_begin(),
+         e = bd->capture_end(); i != e; ++i)
+      if (i->getVariable() == vd)
+        return true;
+    return false;
+  }
+  for (Stmt::const_child_iterator i = s->child_begin(), e = s->child_end();
+       i != e; ++i)
+    if (*i && refersTo(*i, vd))
+      return true;
+  return false;
+}
+
 namespace {
 class DeclToIndex {
   llvm::DenseMap<const VarDecl *, unsigned> map;
+  unsigned numPruned;
 public:
-  DeclToIndex() {}
+  DeclToIndex() : numPruned(0) {}
   
-  /// Compute the actual mapping from declarations to bits.
-  void computeMap(const DeclContext &dc);
+  /// Compute the actual mapping from declarations to bits.  If the body of
+  /// the DeclContext is given, leave out the variables it can be shown not to
+  /// read uninitialized; otherwise map all tracked variables.
+  void computeMap(const DeclContext &dc, const Stmt *body);
   
   /// Return the number of declarations in the map.
   unsigned size() const { return map.size(); }
+
+  /// Return the number of tracked variables left out of the map.
+  unsigned getNumPruned() const { return numPruned; }
   
   /// Returns the bit vector index for a given declaration.
   llvm::Optional<unsigned> getValueIndex(const VarDecl *d) const;
 };
 }
 
-void DeclToIndex::computeMap(const DeclContext &dc) {
+void DeclToIndex::computeMap(const DeclContext &dc, const Stmt *body) {
+  VarUseScanner scanner(dc);
+  llvm::SmallPtrSet<const VarDecl *, 16> alwaysInitialized;
+  if (body) {
+    scanner.scan(body);
+
+    // Unless something can jump past a declaration, a variable declared with
+    // an initializer is initialized before every use, except for uses in the
+    // initializer itself.
+    if (!scanner.hasJumps)
+      for (SmallVectorImpl<const VarDecl *>::iterator
+           I = scanner.initialized.begin(), E = scanner.initialized.end();
+           I != E; ++I)
+        if (!refersTo((*I)->getInit(), *I))
+          alwaysInitialized.insert(*I);
+  }
+
   unsigned count = 0;
   DeclContext::specific_decl_iterator<VarDecl> I(dc.decls_begin()),
                                                E(dc.decls_end());
   for ( ; I != E; ++I) {
     const VarDecl *vd = *I;
-    if (isTrackedVar(vd, &dc))
-      map[vd] = count++;
+    if (!isTrackedVar(vd, &dc))
+      continue;
+    // A variable that is never referenced is never used uninitialized.
+    if (body && (!scanner.referenced.count(vd) ||
+                 alwaysInitialized.count(vd))) {
+      ++numPruned;
+      continue;
+    }
+    map[vd] = count++;
   }
 }
 
@@ -109,8 +223,14 @@ public:
   ~CFGBlockValues();
   
   unsigned getNumEntries() const { return declToIndex.size(); }
+  unsigned getNumPruned() const { return declToIndex.getNumPruned(); }
+
+  /// Return true if the analysis keeps a value for \p vd.
+  bool hasEntry(const VarDecl *vd) const {
+    return declToIndex.getValueIndex(vd).hasValue();
+  }
   
-  void computeSetOfDeclarations(const DeclContext &dc);  
+  void computeSetOfDeclarations(const DeclContext &dc, const Stmt *body);
   ValueVector &getValueVector(const CFGBlock *block,
                                 const CFGBlock *dstBlock);
 
@@ -150,8 +270,9 @@ CFGBlockValues::~CFGBlockValues() {
   delete [] vals;
 }
 
-void CFGBlockValues::computeSetOfDeclarations(const DeclContext &dc) {
-  declToIndex.computeMap(dc);
+void CFGBlockValues::computeSetOfDeclarations(const DeclContext &dc,
+                                              const Stmt *body) {
+  declToIndex.computeMap(dc, body);
   scratch.resize(declToIndex.size());
 }
 
@@ -281,40 +402,69 @@ ValueVector::reference CFGBlockValues::operator[](const VarDecl *vd) {
 
 namespace {
 class DataflowWorklist {
-  SmallVector<const CFGBlock *, 20> worklist;
+  /// A min-heap of the reverse postorder numbers of the enqueued blocks.
+  SmallVector<unsigned, 20> worklist;
   llvm::BitVector enqueuedBlocks;
+  /// The blocks reachable from the entry, in reverse postorder.
+  std::vector<const CFGBlock *> rpoBlocks;
+  /// The reverse postorder number of each block, indexed by block ID.
+  std::vector<unsigned> rpoNumbers;
 public:
-  DataflowWorklist(const CFG &cfg) : enqueuedBlocks(cfg.getNumBlockIDs()) {}
+  DataflowWorklist(const CFG &cfg);
   
   void enqueueSuccessors(const CFGBlock *block);
   const CFGBlock *dequeue();
 };
 }
 
+DataflowWorklist::DataflowWorklist(const CFG &cfg)
+  : enqueuedBlocks(cfg.getNumBlockIDs()),
+    rpoNumbers(cfg.getNumBlockIDs(), 0) {
+  // Always visiting the enqueued block that comes first in reverse postorder
+  // visits blocks after their predecessors wherever the CFG allows it, so
+  // that loops converge in few sweeps.
+  typedef std::pair<const CFGBlock *, CFGBlock::const_succ_iterator> Frame;
+  SmallVector<Frame, 20> stack;
+  llvm::BitVector visited(cfg.getNumBlockIDs());
+  const CFGBlock *entry = &cfg.getEntry();
+  visited[entry->getBlockID()] = true;
+  stack.push_back(Frame(entry, entry->succ_begin()));
+  while (!stack.empty()) {
+    const CFGBlock *block = stack.back().first;
+    if (stack.back().second != block->succ_end()) {
+      const CFGBlock *succ = *stack.back().second++;
+      if (succ && !visited[succ->getBlockID()]) {
+        visited[succ->getBlockID()] = true;
+        stack.push_back(Frame(succ, succ->succ_begin()));
+      }
+      continue;
+    }
+    rpoBlocks.push_back(block);
+    stack.pop_back();
+  }
+  std::reverse(rpoBlocks.begin(), rpoBlocks.end());
+  for (unsigned i = 0, e = rpoBlocks.size(); i != e; ++i)
+    rpoNumbers[rpoBlocks[i]->getBlockID()] = i;
+}
+
 void DataflowWorklist::enqueueSuccessors(const clang::CFGBlock *block) {
-  unsigned OldWorklistSize = worklist.size();
   for (CFGBlock::const_succ_iterator I = block->succ_begin(),
        E = block->succ_end(); I != E; ++I) {
     const CFGBlock *Successor = *I;
     if (!Successor || enqueuedBlocks[Successor->getBlockID()])
       continue;
-    worklist.push_back(Successor);
+    worklist.push_back(rpoNumbers[Successor->getBlockID()]);
+    std::push_heap(worklist.begin(), worklist.end(),
+                   std::greater<unsigned>());
     enqueuedBlocks[Successor->getBlockID()] = true;
   }
-  if (OldWorklistSize == 0 || OldWorklistSize == worklist.size())
-    return;
-
-  // Rotate the newly added blocks to the start of the worklist so that it forms
-  // a proper queue when we pop off the end of the worklist.
-  std::rotate(worklist.begin(), worklist.begin() + OldWorklistSize,
-              worklist.end());
 }
 
 const CFGBlock *DataflowWorklist::dequeue() {
   if (worklist.empty())
     return 0;
-  const CFGBlock *b = worklist.back();
-  worklist.pop_back();
+  std::pop_heap(worklist.begin(), worklist.end(), std::greater<unsigned>());
+  const CFGBlock *b = rpoBlocks[worklist.pop_back_val()];
   enqueuedBlocks[b->getBlockID()] = false;
   return b;
 }
@@ -375,7 +525,7 @@ public:
   void Visit(Stmt *s);
   
   bool isTrackedVar(const VarDecl *vd) {
-    return ::isTrackedVar(vd, cast<DeclContext>(ac.getDecl()));
+    return vals.hasEntry(vd);
   }
   
   FindVarResult findBlockVarDecl(Expr *ex);
@@ -669,6 +819,15 @@ static bool runOnBlock(const CFGBlock *block, const CFG &cfg,
   return vals.updateValueVectorWithScratch(block);
 }
 
+bool clang::hasTrackedVariables(const DeclContext &dc) {
+  DeclContext::specific_decl_iterator<VarDecl> I(dc.decls_begin()),
+                                               E(dc.decls_end());
+  for ( ; I != E; ++I)
+    if (isTrackedVar(*I, &dc))
+      return true;
+  return false;
+}
+
 void clang::runUninitializedVariablesAnalysis(
     const DeclContext &dc,
     const CFG &cfg,
@@ -676,7 +835,8 @@ void clang::runUninitializedVariablesAnalysis(
     UninitVariablesHandler &handler,
     UninitVariablesAnalysisStats &stats) {
   CFGBlockValues vals(cfg);
-  vals.computeSetOfDeclarations(dc);
+  vals.computeSetOfDeclarations(dc, ac.getBody());
+  stats.NumVariablesPruned = vals.getNumPruned();
   if (vals.hasNoDeclarations())
     return;
 
@@ -14,6 +14,7 @@
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/IdentifierTable.h"
 #include "clang/Basic/PartialDiagnostic.h"
+#include "clang/Basic/SourceManager.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/CrashRecoveryContext.h"
@@ -110,6 +111,8 @@ void DiagnosticsEngine::Reset() {
   DiagStates.clear();
   DiagStatePoints.clear();
   DiagStateOnPushStack.clear();
+  DiagStateFiles.clear();
+  DiagStateFilesInvalid = false;
 
   // Create a DiagState and DiagStatePoint representing diagnostic changes
   // through command-line.
@@ -154,6 +157,100 @@ DiagnosticsEngine::GetDiagStatePointForLoc(SourceLocation L) const {
   return Pos;
 }
 
+namespace {
+  /// \brief Orders an offset before the state transitions that follow it.
+  struct TransitionOffsetLess {
+    template<typename TransitionTy>
+    bool operator()(unsigned Offset, const TransitionTy &Transition) const {
+      return Offset < Transition.first;
+    }
+  };
+}
+
+DiagnosticsEngine::DiagState *
+DiagnosticsEngine::DiagStateFile::lookup(unsigned Offset) const {
+  // The first transition is at offset 0, so there always is one at or before
+  // the offset.
+  assert(!Transitions.empty() && Transitions.front().first == 0);
+  return (std::upper_bound(Transitions.begin(), Transitions.end(), Offset,
+                           TransitionOffsetLess()) - 1)->second;
+}
+
+bool DiagnosticsEngine::DiagStateFile::hasTransitionAt(unsigned Offset) const {
+  return (std::upper_bound(Transitions.begin(), Transitions.end(), Offset,
+                           TransitionOffsetLess()) - 1)->first == Offset;
+}
+
+DiagnosticsEngine::DiagStateFile &
+DiagnosticsEngine::getDiagStateFile(FileID FID) const {
+  std::map<FileID, DiagStateFile>::iterator Known = DiagStateFiles.find(FID);
+  if (Known != DiagStateFiles.end())
+    return Known->second;
+
+  // A new file starts with the state in effect where it was included.
+  DiagStateFile &File = DiagStateFiles[FID];
+  SourceLocation IncludeLoc = SourceMgr->getIncludeLoc(FID);
+  DiagState *Initial;
+  if (IncludeLoc.isValid()) {
+    std::pair<FileID, unsigned> Included
+      = SourceMgr->getDecomposedExpansionLoc(IncludeLoc);
+    File.Parent = &getDiagStateFile(Included.first);
+    File.ParentOffset = Included.second;
+    Initial = File.Parent->lookup(Included.second);
+  } else {
+    // Files that are not included from another one are rare (the main file,
+    // the predefines, AST files); order them against the other files the
+    // slow way.
+    Initial = GetDiagStatePointForLoc(SourceMgr->getLocForStartOfFile(FID))
+                ->State;
+  }
+  File.Transitions.push_back(std::make_pair(0u, Initial));
+  return File;
+}
+
+void DiagnosticsEngine::addDiagStateTransition(SourceLocation Loc,
+                                               DiagState *State) const {
+  std::pair<FileID, unsigned> Decomp
+    = SourceMgr->getDecomposedExpansionLoc(Loc);
+  unsigned Offset = Decomp.second;
+  for (DiagStateFile *File = &getDiagStateFile(Decomp.first); File;
+       Offset = File->ParentOffset, File = File->Parent) {
+    std::pair<unsigned, DiagState *> &Last = File->Transitions.back();
+    assert(Last.first <= Offset && "State transitions added out of order");
+    if (Last.first == Offset)
+      Last.second = State;
+    else
+      File->Transitions.push_back(std::make_pair(Offset, State));
+  }
+}
+
+DiagnosticsEngine::DiagState *
+DiagnosticsEngine::GetDiagStateForLoc(SourceLocation Loc) const {
+  assert(!DiagStatePoints.empty());
+
+  // Common cases; no diagnostic pragmas, or asking for the latest state.
+  if (DiagStatePoints.size() == 1 || Loc.isInvalid())
+    return GetCurDiagState();
+
+  if (DiagStateFilesInvalid) {
+    DiagStateFiles.clear();
+    DiagStateFilesInvalid = false;
+    for (unsigned I = 1, N = DiagStatePoints.size(); I != N; ++I)
+      addDiagStateTransition(DiagStatePoints[I].Loc, DiagStatePoints[I].State);
+  }
+
+  std::pair<FileID, unsigned> Decomp
+    = SourceMgr->getDecomposedExpansionLoc(Loc);
+  const DiagStateFile &File = getDiagStateFile(Decomp.first);
+
+  // Every location within a macro expansion has the offset of the expansion.
+  // If _Pragma changed the state within the expansion containing Loc, order
+  // Loc against those changes the slow way.
+  if (Loc.isMacroID() && File.hasTransitionAt(Decomp.second))
+    return GetDiagStatePointForLoc(Loc)->State;
+  return File.lookup(Decomp.second);
+}
+
 /// \brief This allows the client to specify that certain
 /// warnings are ignored.  Notes can never be mapped, errors can only be
 /// mapped to fatal, and WARNINGs and EXTENSIONs can be mapped arbitrarily.
@@ -227,6 +324,7 @@ void DiagnosticsEngine::setDiagnosticMapping(diag::kind Diag, diag::Mapping Map,
   GetCurDiagState()->setMappingInfo(Diag, MappingInfo);
   DiagStatePoints.insert(Pos+1, DiagStatePoint(NewState,
                                                FullSourceLoc(Loc, *SourceMgr)));
+  DiagStateFilesInvalid = true;
 }
 
 bool DiagnosticsEngine::setDiagnosticGroupMapping(
@@ -521,9 +521,7 @@ DiagnosticIDs::getDiagnosticLevel(unsigned DiagID, unsigned DiagClass,
   // to error.  Errors can only be mapped to fatal.
   DiagnosticIDs::Level Result = DiagnosticIDs::Fatal;
 
-  DiagnosticsEngine::DiagStatePointsTy::iterator
-    Pos = Diag.GetDiagStatePointForLoc(Loc);
-  DiagnosticsEngine::DiagState *State = Pos->State;
+  DiagnosticsEngine::DiagState *State = Diag.GetDiagStateForLoc(Loc);
 
   // Get the mapping information, or compute it lazily.
   DiagnosticMappingInfo &MappingInfo = State->getOrAddMappingInfo(
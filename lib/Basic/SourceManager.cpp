@@ -403,6 +403,8 @@ void SourceManager::clearIDTables() {
   LastLineNoFileIDQuery = FileID();
   LastLineNoContentCache = 0;
   LastFileIDLookup = FileID();
+  LocalIncludeTree.clear();
+  LoadedIncludeTree.clear();
 
   if (LineTable)
     LineTable->clear();
@@ -1660,6 +1662,93 @@ static bool MoveUpIncludeHierarchy(std::pair<FileID, unsigned> &Loc,
 }
   
 
+/// \brief Return the slot holding the include tree node of \p FID, growing
+/// the tables to cover SLocEntries created since the last query.
+SourceManager::IncludeTreeNode &
+SourceManager::getIncludeTreeSlot(FileID FID) const {
+  if (FID.ID >= 0) {
+    if (unsigned(FID.ID) >= LocalIncludeTree.size())
+      LocalIncludeTree.resize(LocalSLocEntryTable.size());
+    return LocalIncludeTree[FID.ID];
+  }
+
+  unsigned Index = unsigned(-FID.ID - 2);
+  if (Index >= LoadedIncludeTree.size())
+    LoadedIncludeTree.resize(LoadedSLocEntryTable.size());
+  return LoadedIncludeTree[Index];
+}
+
+/// \brief Return the include tree node of \p FID, computing it and those of
+/// its ancestors if needed. SLocEntries never change once created, so each
+/// node is computed only once.
+SourceManager::IncludeTreeNode
+SourceManager::getIncludeTreeNode(FileID FID) const {
+  if (getIncludeTreeSlot(FID).Depth != ~0U)
+    return getIncludeTreeSlot(FID);
+
+  // Walk up to the nearest ancestor whose node is already known.
+  SmallVector<std::pair<FileID, std::pair<FileID, unsigned> >, 8> Pending;
+  FileID Cur = FID;
+  do {
+    std::pair<FileID, unsigned> Up(Cur, 0);
+    if (MoveUpIncludeHierarchy(Up, *this))
+      Up = std::make_pair(FileID(), 0U);
+    Pending.push_back(std::make_pair(Cur, Up));
+    Cur = Up.first;
+  } while (Cur.isValid() && getIncludeTreeSlot(Cur).Depth == ~0U);
+
+  // Then fill in the nodes from the top down.
+  IncludeTreeNode Node;
+  while (!Pending.empty()) {
+    FileID Child = Pending.back().first;
+    Node.Parent = Pending.back().second.first;
+    Node.ParentOffset = Pending.back().second.second;
+    Pending.pop_back();
+
+    if (Node.Parent.isInvalid()) {
+      Node.Depth = 0;
+      Node.Jump = Child;
+    } else {
+      IncludeTreeNode Parent = getIncludeTreeSlot(Node.Parent);
+      IncludeTreeNode ParentJump = getIncludeTreeSlot(Parent.Jump);
+      IncludeTreeNode ParentJumpJump = getIncludeTreeSlot(ParentJump.Jump);
+      Node.Depth = Parent.Depth + 1;
+      if (Parent.Depth - ParentJump.Depth ==
+          ParentJump.Depth - ParentJumpJump.Depth)
+        Node.Jump = ParentJump.Jump;
+      else
+        Node.Jump = Node.Parent;
+    }
+    getIncludeTreeSlot(Child) = Node;
+  }
+  return Node;
+}
+
+/// \brief Move the decomposed location \p Loc, whose include tree node is
+/// \p Node, up to its ancestor at \p Depth, if it is deeper than that.
+void SourceManager::moveUpIncludeTree(std::pair<FileID, unsigned> &Loc,
+                                      IncludeTreeNode &Node,
+                                      unsigned Depth) const {
+  if (Node.Depth <= Depth)
+    return;
+
+  // Find the ancestor right below Depth; its include location is Loc's
+  // position in the ancestor at Depth.
+  while (Node.Depth > Depth + 1) {
+    IncludeTreeNode Jump = getIncludeTreeNode(Node.Jump);
+    if (Jump.Depth > Depth) {
+      Loc.first = Node.Jump;
+      Node = Jump;
+    } else {
+      Loc.first = Node.Parent;
+      Node = getIncludeTreeNode(Node.Parent);
+    }
+  }
+
+  Loc = std::make_pair(Node.Parent, Node.ParentOffset);
+  Node = getIncludeTreeNode(Node.Parent);
+}
+
 /// \brief Determines the order of 2 source locations in the translation unit.
 ///
 /// \returns true if LHS source location comes before RHS, false otherwise.
@@ -1685,28 +1774,37 @@ bool SourceManager::isBeforeInTranslationUnit(SourceLocation LHS,
   IsBeforeInTUCache.setQueryFIDs(LOffs.first, ROffs.first,
                           /*isLFIDBeforeRFID=*/LOffs.first.ID < ROffs.first.ID);
 
-  // We need to find the common ancestor. The only way of doing this is to
-  // build the complete include chain for one and then walking up the chain
-  // of the other looking for a match.
-  // We use a map from FileID to Offset to store the chain. Easier than writing
-  // a custom set hash info that only depends on the first part of a pair.
-  typedef llvm::DenseMap<FileID, unsigned> LocSet;
-  LocSet LChain;
-  do {
-    LChain.insert(LOffs);
-    // We catch the case where LOffs is in a file included by ROffs and
-    // quit early. The other way round unfortunately remains suboptimal.
-  } while (LOffs.first != ROffs.first && !MoveUpIncludeHierarchy(LOffs, *this));
-  LocSet::iterator I;
-  while((I = LChain.find(ROffs.first)) == LChain.end()) {
-    if (MoveUpIncludeHierarchy(ROffs, *this))
-      break; // Met at topmost file.
+  // We need to find the common ancestor. First bring the deeper of the two
+  // locations up to the depth of the other one; if they meet, one file
+  // includes the other.
+  IncludeTreeNode LNode = getIncludeTreeNode(LOffs.first);
+  IncludeTreeNode RNode = getIncludeTreeNode(ROffs.first);
+  moveUpIncludeTree(LOffs, LNode, RNode.Depth);
+  moveUpIncludeTree(ROffs, RNode, LNode.Depth);
+
+  // Otherwise walk both up in lock step until they are included into the
+  // same file. Both nodes are at the same depth, so their jumps are too.
+  if (LOffs.first != ROffs.first) {
+    while (LNode.Parent != RNode.Parent) {
+      FileID LNext = LNode.Parent, RNext = RNode.Parent;
+      if (LNode.Jump != RNode.Jump) {
+        LNext = LNode.Jump;
+        RNext = RNode.Jump;
+      }
+      LOffs.first = LNext;
+      ROffs.first = RNext;
+      LNode = getIncludeTreeNode(LNext);
+      RNode = getIncludeTreeNode(RNext);
+    }
+
+    if (LNode.Parent.isValid()) {
+      LOffs = std::make_pair(LNode.Parent, LNode.ParentOffset);
+      ROffs = std::make_pair(RNode.Parent, RNode.ParentOffset);
+    }
   }
-  if (I != LChain.end())
-    LOffs = *I;
 
-  // If we exited because we found a nearest common ancestor, compare the
-  // locations within the common file and cache them.
+  // If we found a nearest common ancestor, compare the locations within the
+  // common file and cache them.
   if (LOffs.first == ROffs.first) {
     IsBeforeInTUCache.setCommonLoc(LOffs.first, LOffs.second, ROffs.second);
     return IsBeforeInTUCache.getCachedResult(LOffs.second, ROffs.second);
@@ -1787,6 +1885,8 @@ size_t SourceManager::getDataStructureSizes() const {
     + llvm::capacity_in_bytes(LocalSLocEntryTable)
     + llvm::capacity_in_bytes(LoadedSLocEntryTable)
     + llvm::capacity_in_bytes(SLocEntryLoaded)
+    + llvm::capacity_in_bytes(LocalIncludeTree)
+    + llvm::capacity_in_bytes(LoadedIncludeTree)
     + llvm::capacity_in_bytes(FileInfos)
     + llvm::capacity_in_bytes(OverriddenFiles);
 }
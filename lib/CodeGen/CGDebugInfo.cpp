@@ -34,6 +34,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Dwarf.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetData.h"
 #include "llvm/Target/TargetMachine.h"
 using namespace clang;
@@ -41,7 +42,8 @@ using namespace clang::CodeGen;
 
 CGDebugInfo::CGDebugInfo(CodeGenModule &CGM)
   : CGM(CGM), DBuilder(CGM.getModule()),
-    BlockLiteralGenericSet(false) {
+    BlockLiteralGenericSet(false), NumRecordDefinitions(0),
+    NumRecordDefinitionElements(0), NumRecordDeclarations(0) {
   CreateCompileUnit();
 }
 
@@ -50,6 +52,16 @@ CGDebugInfo::~CGDebugInfo() {
          "Region stack mismatch, stack not empty!");
 }
 
+void CGDebugInfo::PrintStats() const {
+  llvm::errs() << "\n*** Debug Info Stats:\n";
+  llvm::errs() << "  " << TypeCache.size() << " types cached.\n";
+  llvm::errs() << "  " << NumRecordDefinitions
+               << " record types described with their definition ("
+               << NumRecordDefinitionElements << " elements).\n";
+  llvm::errs() << "  " << NumRecordDeclarations
+               << " record types described as declarations only.\n";
+}
+
 void CGDebugInfo::setLocation(SourceLocation Loc) {
   // If the new location isn't valid return.
   if (!Loc.isValid()) return;
@@ -486,32 +498,37 @@ llvm::DIType CGDebugInfo::CreatePointeeType(QualType PointeeTy,
   if (!CGM.getCodeGenOpts().LimitDebugInfo)
     return getOrCreateType(PointeeTy, Unit);
   
-  if (const RecordType *RTy = dyn_cast<RecordType>(PointeeTy)) {
-    RecordDecl *RD = RTy->getDecl();
-    llvm::DIFile DefUnit = getOrCreateFile(RD->getLocation());
-    unsigned Line = getLineNumber(RD->getLocation());
-    llvm::DIDescriptor FDContext =
-      getContextDescriptor(cast<Decl>(RD->getDeclContext()));
-
-    if (RD->isStruct())
-      return DBuilder.createStructType(FDContext, RD->getName(), DefUnit,
-                                       Line, 0, 0, llvm::DIType::FlagFwdDecl,
-                                       llvm::DIArray());
-    else if (RD->isUnion())
-      return DBuilder.createUnionType(FDContext, RD->getName(), DefUnit,
-                                      Line, 0, 0, llvm::DIType::FlagFwdDecl,
-                                      llvm::DIArray());
-    else {
-      assert(RD->isClass() && "Unknown RecordType!");
-      return DBuilder.createClassType(FDContext, RD->getName(), DefUnit,
-                                      Line, 0, 0, 0, llvm::DIType::FlagFwdDecl,
-                                      llvm::DIType(), llvm::DIArray());
-    }
-  }
+  if (const RecordType *RTy = dyn_cast<RecordType>(PointeeTy))
+    return createRecordFwdDecl(RTy->getDecl());
   return getOrCreateType(PointeeTy, Unit);
 
 }
 
+/// createRecordFwdDecl - Create a declaration of the given record, without
+/// any of its members.
+llvm::DIType CGDebugInfo::createRecordFwdDecl(const RecordDecl *RD) {
+  ++NumRecordDeclarations;
+  llvm::DIFile DefUnit = getOrCreateFile(RD->getLocation());
+  unsigned Line = getLineNumber(RD->getLocation());
+  llvm::DIDescriptor FDContext =
+    getContextDescriptor(cast<Decl>(RD->getDeclContext()));
+
+  if (RD->isStruct())
+    return DBuilder.createStructType(FDContext, RD->getName(), DefUnit,
+                                     Line, 0, 0, llvm::DIType::FlagFwdDecl,
+                                     llvm::DIArray());
+  else if (RD->isUnion())
+    return DBuilder.createUnionType(FDContext, RD->getName(), DefUnit,
+                                    Line, 0, 0, llvm::DIType::FlagFwdDecl,
+                                    llvm::DIArray());
+  else {
+    assert(RD->isClass() && "Unknown RecordType!");
+    return DBuilder.createClassType(FDContext, RD->getName(), DefUnit,
+                                    Line, 0, 0, 0, llvm::DIType::FlagFwdDecl,
+                                    llvm::DIType(), llvm::DIArray());
+  }
+}
+
 llvm::DIType CGDebugInfo::CreatePointerLikeType(unsigned Tag,
                                                 const Type *Ty, 
                                                 QualType PointeeTy,
@@ -1025,6 +1042,19 @@ CollectVTableInfo(const CXXRecordDecl *RD, llvm::DIFile Unit,
   EltTys.push_back(VPTR);
 }
 
+/// CompleteClassType - The vtable of the given class is emitted in this
+/// translation unit, which makes it the one that describes the class in full
+/// when debug info is limited.
+void CGDebugInfo::CompleteClassType(const CXXRecordDecl *RD) {
+  QualType Ty = CGM.getContext().getRecordType(RD);
+
+  // The class may have been declared only, if its key function was not
+  // defined yet when it was first described.
+  if (DeclaredOnlyClasses.erase(RD))
+    TypeCache.erase(Ty.getAsOpaquePtr());
+  getOrCreateRecordType(Ty, RD->getLocation());
+}
+
 /// getOrCreateRecordType - Emit record type's standalone debug info. 
 llvm::DIType CGDebugInfo::getOrCreateRecordType(QualType RTy, 
                                                 SourceLocation Loc) {
@@ -1033,6 +1063,27 @@ llvm::DIType CGDebugInfo::getOrCreateRecordType(QualType RTy,
   return T;
 }
 
+/// isDescribedElsewhere - Return true if the given class is described in full
+/// by another translation unit: the one that defines its key function, and
+/// therefore emits its vtable.
+static bool isDescribedElsewhere(ASTContext &Context,
+                                 const CXXRecordDecl *RD) {
+  if (!RD->isDynamicClass())
+    return false;
+
+  // Every translation unit that uses an implicit instantiation emits its
+  // vtable.
+  TemplateSpecializationKind TSK = RD->getTemplateSpecializationKind();
+  if (TSK == TSK_ExplicitInstantiationDeclaration)
+    return true;
+  if (TSK == TSK_ImplicitInstantiation ||
+      TSK == TSK_ExplicitInstantiationDefinition)
+    return false;
+
+  const CXXMethodDecl *KeyFunction = Context.getKeyFunction(RD);
+  return KeyFunction && !KeyFunction->hasBody();
+}
+
 /// CreateType - get structure or union type.
 llvm::DIType CGDebugInfo::CreateType(const RecordType *Ty) {
   RecordDecl *RD = Ty->getDecl();
@@ -1054,6 +1105,7 @@ llvm::DIType CGDebugInfo::CreateType(const RecordType *Ty) {
   // If this is just a forward declaration, construct an appropriately
   // marked node and just return it.
   if (!RD->getDefinition()) {
+    ++NumRecordDeclarations;
     llvm::DIType FwdDecl =
       DBuilder.createStructType(FDContext, RD->getName(),
                                 DefUnit, Line, 0, 0,
@@ -1063,6 +1115,16 @@ llvm::DIType CGDebugInfo::CreateType(const RecordType *Ty) {
       return FwdDecl;
   }
 
+  // When limiting debug info, leave the full description of a class to the
+  // translation unit that emits its vtable; see CompleteClassType.
+  if (CGM.getCodeGenOpts().LimitDebugInfo) {
+    const CXXRecordDecl *CXXRD = dyn_cast<CXXRecordDecl>(RD);
+    if (CXXRD && isDescribedElsewhere(CGM.getContext(), CXXRD)) {
+      DeclaredOnlyClasses.insert(CXXRD);
+      return createRecordFwdDecl(RD);
+    }
+  }
+
   llvm::DIType FwdDecl = DBuilder.createTemporaryType(DefUnit);
 
   llvm::MDNode *MN = FwdDecl;
@@ -1123,6 +1185,9 @@ llvm::DIType CGDebugInfo::CreateType(const RecordType *Ty) {
   if (RI != RegionMap.end())
     RegionMap.erase(RI);
 
+  ++NumRecordDefinitions;
+  NumRecordDefinitionElements += EltTys.size();
+
   llvm::DIDescriptor RDContext =  
     getContextDescriptor(cast<Decl>(RD->getDeclContext()));
   StringRef RDName = RD->getName();
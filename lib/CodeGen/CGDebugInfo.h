@@ -18,6 +18,7 @@
 #include "clang/AST/Expr.h"
 #include "clang/Basic/SourceLocation.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Analysis/DebugInfo.h"
 #include "llvm/Analysis/DIBuilder.h"
 #include "llvm/Support/ValueHandle.h"
@@ -73,6 +74,15 @@ class CGDebugInfo {
   llvm::DenseMap<const FunctionDecl *, llvm::WeakVH> SPCache;
   llvm::DenseMap<const NamespaceDecl *, llvm::WeakVH> NameSpaceCache;
 
+  /// DeclaredOnlyClasses - Classes described without their members because
+  /// another translation unit emits their vtable.
+  llvm::SmallPtrSet<const CXXRecordDecl *, 16> DeclaredOnlyClasses;
+
+  /// Statistics about the record types described, for PrintStats.
+  unsigned NumRecordDefinitions;
+  unsigned NumRecordDefinitionElements;
+  unsigned NumRecordDeclarations;
+
   /// Helper functions for getOrCreateType.
   llvm::DIType CreateType(const BuiltinType *Ty);
   llvm::DIType CreateType(const ComplexType *Ty);
@@ -101,6 +111,7 @@ class CGDebugInfo {
   llvm::DIType getOrCreateVTablePtrType(llvm::DIFile F);
   llvm::DINameSpace getOrCreateNameSpace(const NamespaceDecl *N);
   llvm::DIType CreatePointeeType(QualType PointeeTy, llvm::DIFile F);
+  llvm::DIType createRecordFwdDecl(const RecordDecl *RD);
   llvm::DIType CreatePointerLikeType(unsigned Tag,
                                      const Type *Ty, QualType PointeeTy,
                                      llvm::DIFile F);
@@ -156,6 +167,9 @@ public:
   ~CGDebugInfo();
   void finalize() { DBuilder.finalize(); }
 
+  /// PrintStats - Print how many types were described, and how.
+  void PrintStats() const;
+
   /// setLocation - Update the current source location. If \arg loc is
   /// invalid it is ignored.
   void setLocation(SourceLocation Loc);
@@ -219,6 +233,10 @@ public:
 
   /// getOrCreateRecordType - Emit record type's standalone debug info. 
   llvm::DIType getOrCreateRecordType(QualType Ty, SourceLocation L);
+
+  /// CompleteClassType - Emit the full description of a class whose vtable
+  /// is emitted in this translation unit.
+  void CompleteClassType(const CXXRecordDecl *RD);
 private:
   /// EmitDeclare - Emit call to llvm.dbg.declare for a variable declaration.
   void EmitDeclare(const VarDecl *decl, unsigned Tag, llvm::Value *AI,
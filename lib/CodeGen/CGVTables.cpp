@@ -14,6 +14,7 @@
 #include "CodeGenModule.h"
 #include "CodeGenFunction.h"
 #include "CGCXXABI.h"
+#include "CGDebugInfo.h"
 #include "clang/AST/CXXInheritance.h"
 #include "clang/AST/RecordLayout.h"
 #include "clang/Frontend/CodeGenOptions.h"
@@ -718,6 +719,13 @@ CodeGenVTables::GenerateClassData(llvm::GlobalVariable::LinkageTypes Linkage,
 
   EmitVTableDefinition(VTable, Linkage, RD);
 
+  // Under limited debug info, the translation unit that emits the vtable is
+  // the one that describes the class in full.
+  CGDebugInfo *DI = CGM.getModuleDebugInfo();
+  if (DI && CGM.getCodeGenOpts().LimitDebugInfo &&
+      Linkage != llvm::GlobalVariable::AvailableExternallyLinkage)
+    DI->CompleteClassType(RD);
+
   if (RD->getNumVBases()) {
     llvm::GlobalVariable *VTT = GetAddrOfVTT(RD);
     EmitVTTDefinition(VTT, Linkage, RD);
@@ -167,6 +167,11 @@ void CodeGenModule::Release() {
     DebugInfo->finalize();
 }
 
+void CodeGenModule::PrintStats() const {
+  if (DebugInfo)
+    DebugInfo->PrintStats();
+}
+
 void CodeGenModule::UpdateCompletedType(const TagDecl *TD) {
   // Make sure that this type is translated.
   Types.UpdateCompletedType(TD);
@@ -355,6 +355,9 @@ public:
   /// Release - Finalize LLVM code generation.
   void Release();
 
+  /// PrintStats - Print statistics about the generated code.
+  void PrintStats() const;
+
   /// getObjCRuntime() - Return a reference to the configured
   /// Objective-C runtime.
   CGObjCRuntime &getObjCRuntime() {
@@ -96,6 +96,11 @@ namespace {
         Builder->Release();
     }
 
+    virtual void PrintStats() {
+      if (Builder)
+        Builder->PrintStats();
+    }
+
     virtual void CompleteTentativeDefinition(VarDecl *D) {
       if (Diags.hasErrorOccurred())
         return;
@@ -70,6 +70,16 @@ static const char *getAnalysisPurgeModeName(AnalysisPurgeMode Kind) {
   }
 }
 
+static const char *getAnalysisLivenessModeName(AnalysisLivenessMode Kind) {
+  switch (Kind) {
+  default:
+    llvm_unreachable("Unknown liveness mode!");
+#define ANALYSIS_LIVENESS(NAME, CMDFLAG, DESC) \
+  case NAME: return CMDFLAG;
+#include "clang/Frontend/Analyses.def"
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // Serialization (to args)
 //===----------------------------------------------------------------------===//
@@ -94,6 +104,10 @@ static void AnalyzerOptsToArgs(const AnalyzerOptions &Opts,
     Res.push_back("-analyzer-purge");
     Res.push_back(getAnalysisPurgeModeName(Opts.AnalysisPurgeOpt));
   }
+  if (Opts.AnalysisLivenessOpt != LivenessAuto) {
+    Res.push_back("-analyzer-liveness");
+    Res.push_back(getAnalysisLivenessModeName(Opts.AnalysisLivenessOpt));
+  }
   if (!Opts.AnalyzeSpecificFunction.empty()) {
     Res.push_back("-analyze-function");
     Res.push_back(Opts.AnalyzeSpecificFunction);
@@ -102,6 +116,8 @@ static void AnalyzerOptsToArgs(const AnalyzerOptions &Opts,
     Res.push_back("-analyzer-opt-analyze-headers");
   if (Opts.AnalyzerDisplayProgress)
     Res.push_back("-analyzer-display-progress");
+  if (Opts.CheckerStats)
+    Res.push_back("-analyzer-checker-stats");
   if (Opts.AnalyzeNestedBlocks)
     Res.push_back("-analyzer-opt-analyze-nested-blocks");
   if (Opts.EagerlyAssume)
@@ -432,6 +448,12 @@ static void FrontendOptsToArgs(const FrontendOptions &Opts,
     Res.push_back("-print-stats");
   if (Opts.ShowTimers)
     Res.push_back("-ftime-report");
+  if (Opts.ShowTemplateInstantiationProfile)
+    Res.push_back("-ftemplate-instantiation-profile");
+  if (!Opts.TemplateInstantiationTraceFile.empty()) {
+    Res.push_back("-ftemplate-instantiation-trace");
+    Res.push_back(Opts.TemplateInstantiationTraceFile);
+  }
   if (Opts.ShowVersion)
     Res.push_back("-version");
   if (Opts.FixWhatYouCan)
@@ -779,6 +801,19 @@ static void LangOptsToArgs(const LangOptions &Opts,
     Res.push_back("-fdebugger-support");
   if (Opts.DelayedTemplateParsing)
     Res.push_back("-fdelayed-template-parsing");
+  if (Opts.PCHInstantiateTemplates)
+    Res.push_back("-fpch-instantiate-templates");
+  if (Opts.ConstantEvaluationCache)
+    Res.push_back("-fconstant-evaluation-cache");
+  switch (Opts.getConstantEvaluator()) {
+  case LangOptions::CE_Tree: break;
+  case LangOptions::CE_Bytecode:
+    Res.push_back("-fconstant-evaluator=bytecode");
+    break;
+  case LangOptions::CE_Check:
+    Res.push_back("-fconstant-evaluator=check");
+    break;
+  }
   if (Opts.Deprecated)
     Res.push_back("-fdeprecated-macro");
 }
@@ -969,11 +1004,26 @@ static void ParseAnalyzerArgs(AnalyzerOptions &Opts, ArgList &Args,
       Opts.AnalysisPurgeOpt = Value;
   }
 
+  if (Arg *A = Args.getLastArg(OPT_analyzer_liveness)) {
+    StringRef Name = A->getValue(Args);
+    AnalysisLivenessMode Value = llvm::StringSwitch<AnalysisLivenessMode>(Name)
+#define ANALYSIS_LIVENESS(NAME, CMDFLAG, DESC) \
+      .Case(CMDFLAG, NAME)
+#include "clang/Frontend/Analyses.def"
+      .Default(NumLivenessModes);
+    if (Value == NumLivenessModes)
+      Diags.Report(diag::err_drv_invalid_value)
+        << A->getAsString(Args) << Name;
+    else
+      Opts.AnalysisLivenessOpt = Value;
+  }
+
   Opts.ShowCheckerHelp = Args.hasArg(OPT_analyzer_checker_help);
   Opts.VisualizeEGDot = Args.hasArg(OPT_analyzer_viz_egraph_graphviz);
   Opts.VisualizeEGUbi = Args.hasArg(OPT_analyzer_viz_egraph_ubigraph);
   Opts.AnalyzeAll = Args.hasArg(OPT_analyzer_opt_analyze_headers);
   Opts.AnalyzerDisplayProgress = Args.hasArg(OPT_analyzer_display_progress);
+  Opts.CheckerStats = Args.hasArg(OPT_analyzer_checker_stats);
   Opts.AnalyzeNestedBlocks =
     Args.hasArg(OPT_analyzer_opt_analyze_nested_blocks);
   Opts.EagerlyAssume = Args.hasArg(OPT_analyzer_eagerly_assume);
@@ -1306,6 +1356,10 @@ static InputKind ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
     = !Args.hasArg(OPT_no_code_completion_globals);
   Opts.ShowStats = Args.hasArg(OPT_print_stats);
   Opts.ShowTimers = Args.hasArg(OPT_ftime_report);
+  Opts.ShowTemplateInstantiationProfile
+    = Args.hasArg(OPT_ftemplate_instantiation_profile);
+  Opts.TemplateInstantiationTraceFile
+    = Args.getLastArgValue(OPT_ftemplate_instantiation_trace);
   Opts.ShowVersion = Args.hasArg(OPT_version);
   Opts.ASTMergeFiles = Args.getAllArgValues(OPT_ast_merge);
   Opts.LLVMArgs = Args.getAllArgValues(OPT_mllvm);
@@ -1739,6 +1793,21 @@ static void ParseLangArgs(LangOptions &Opts, ArgList &Args, InputKind IK,
   Opts.InstantiationDepth = Args.getLastArgIntValue(OPT_ftemplate_depth, 1024,
                                                Diags);
   Opts.DelayedTemplateParsing = Args.hasArg(OPT_fdelayed_template_parsing);
+  Opts.PCHInstantiateTemplates = Args.hasArg(OPT_fpch_instantiate_templates);
+  Opts.ConstantEvaluationCache = Args.hasArg(OPT_fconstant_evaluation_cache);
+  if (Arg *A = Args.getLastArg(OPT_fconstant_evaluator_EQ)) {
+    StringRef Name = A->getValue(Args);
+    unsigned Evaluator = llvm::StringSwitch<unsigned>(Name)
+      .Case("tree", LangOptions::CE_Tree)
+      .Case("bytecode", LangOptions::CE_Bytecode)
+      .Case("check", LangOptions::CE_Check)
+      .Default(~0U);
+    if (Evaluator == ~0U)
+      Diags.Report(diag::err_drv_invalid_value) << A->getAsString(Args) << Name;
+    else
+      Opts.setConstantEvaluator(
+        static_cast<LangOptions::ConstantEvaluatorKind>(Evaluator));
+  }
   Opts.NumLargeByValueCopy = Args.getLastArgIntValue(OPT_Wlarge_by_value_copy,
                                                     0, Diags);
   Opts.MSBitfields = Args.hasArg(OPT_mms_bitfields);
@@ -19,6 +19,8 @@
 #include "clang/Frontend/FrontendPluginRegistry.h"
 #include "clang/Frontend/MultiplexConsumer.h"
 #include "clang/Parse/ParseAST.h"
+#include "clang/Sema/Sema.h"
+#include "clang/Sema/TemplateInstantiationProfiler.h"
 #include "clang/Serialization/ASTDeserializationListener.h"
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/ChainedIncludesSource.h"
@@ -376,7 +378,31 @@ void ASTFrontendAction::ExecuteAction() {
   if (!CI.hasSema())
     CI.createSema(getTranslationUnitKind(), CompletionConsumer);
 
+  const FrontendOptions &FEOpts = CI.getFrontendOpts();
+  bool TraceInstantiations = !FEOpts.TemplateInstantiationTraceFile.empty();
+  if (FEOpts.ShowTemplateInstantiationProfile || TraceInstantiations)
+    CI.getSema().enableTemplateInstantiationProfiling(TraceInstantiations);
+
   ParseAST(CI.getSema(), CI.getFrontendOpts().ShowStats);
+
+  sema::TemplateInstantiationProfiler *Profiler
+    = CI.getSema().getTemplateInstantiationProfiler();
+  if (!Profiler)
+    return;
+
+  if (FEOpts.ShowTemplateInstantiationProfile)
+    Profiler->printReport(llvm::errs());
+
+  if (TraceInstantiations) {
+    std::string ErrorInfo;
+    llvm::raw_fd_ostream OS(FEOpts.TemplateInstantiationTraceFile.c_str(),
+                            ErrorInfo);
+    if (!ErrorInfo.empty())
+      CI.getDiagnostics().Report(diag::err_fe_unable_to_open_output)
+        << FEOpts.TemplateInstantiationTraceFile << ErrorInfo;
+    else
+      Profiler->writeTraceEvents(OS);
+  }
 }
 
 ASTConsumer *
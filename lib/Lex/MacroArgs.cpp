@@ -62,7 +62,17 @@ MacroArgs *MacroArgs::create(const MacroInfo *MI,
   // Copy the actual unexpanded tokens to immediately after the result ptr.
   if (!UnexpArgTokens.empty())
     std::copy(UnexpArgTokens.begin(), UnexpArgTokens.end(), 
-              const_cast<Token*>(Result->getUnexpArgument(0)));
+              const_cast<Token*>((const Token *)(Result+1)));
+
+  // Remember where each argument starts.  Every argument, including an empty
+  // one, is terminated by an EOF token.
+  Result->UnexpArgStarts.clear();
+  unsigned ArgStart = 0;
+  for (unsigned i = 0, e = UnexpArgTokens.size(); i != e; ++i)
+    if (UnexpArgTokens[i].is(tok::eof)) {
+      Result->UnexpArgStarts.push_back(ArgStart);
+      ArgStart = i+1;
+    }
 
   return Result;
 }
@@ -113,15 +123,8 @@ const Token *MacroArgs::getUnexpArgument(unsigned Arg) const {
   // The unexpanded argument tokens start immediately after the MacroArgs object
   // in memory.
   const Token *Start = (const Token *)(this+1);
-  const Token *Result = Start;
-  // Scan to find Arg.
-  for (; Arg; ++Result) {
-    assert(Result < Start+NumUnexpArgTokens && "Invalid arg #");
-    if (Result->is(tok::eof))
-      --Arg;
-  }
-  assert(Result < Start+NumUnexpArgTokens && "Invalid arg #");
-  return Result;
+  assert(Arg < UnexpArgStarts.size() && "Invalid arg #");
+  return Start+UnexpArgStarts[Arg];
 }
 
 
@@ -153,7 +156,11 @@ MacroArgs::getPreExpArgument(unsigned Arg, const MacroInfo *MI,
     PreExpArgTokens.resize(MI->getNumArgs());
   
   std::vector<Token> &Result = PreExpArgTokens[Arg];
-  if (!Result.empty()) return Result;
+  if (!Result.empty()) {
+    ++PP.NumMacroArgsPreExpReused;
+    return Result;
+  }
+  ++PP.NumMacroArgsPreExpanded;
 
   const Token *AT = getUnexpArgument(Arg);
   unsigned NumToks = getArgLength(AT)+1;  // Include the EOF.
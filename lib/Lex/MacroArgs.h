@@ -14,7 +14,9 @@
 #ifndef LLVM_CLANG_MACROARGS_H
 #define LLVM_CLANG_MACROARGS_H
 
+#include "clang/Basic/LLVM.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
 
 #include <vector>
 
@@ -39,6 +41,11 @@ class MacroArgs {
   /// if in strict mode and the C99 varargs macro had only a ... argument, this
   /// is false.
   bool VarargsElided;
+
+  /// UnexpArgStarts - The index of the first unexpanded token of each
+  /// argument, so that getUnexpArgument doesn't have to rescan the EOF-separated
+  /// token list on every use of an argument.
+  SmallVector<unsigned, 8> UnexpArgStarts;
   
   /// PreExpArgTokens - Pre-expanded tokens for arguments that need them.  Empty
   /// if not yet computed.  This includes the EOF marker at the end of the
@@ -86,6 +93,13 @@ public:
   const std::vector<Token> &
     getPreExpArgument(unsigned Arg, const MacroInfo *MI, Preprocessor &PP);
 
+  /// hasPreExpArgument - Return true if the pre-expanded form of the specified
+  /// argument has already been computed for this invocation, as happens when
+  /// a formal is used more than once in the macro body.
+  bool hasPreExpArgument(unsigned Arg) const {
+    return Arg < PreExpArgTokens.size() && !PreExpArgTokens[Arg].empty();
+  }
+
   /// getStringifiedArgument - Compute, cache, and return the specified argument
   /// that has been 'stringified' as required by the # operator.
   const Token &getStringifiedArgument(unsigned ArgNo, Preprocessor &PP,
@@ -29,6 +29,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include <cstdio>
 #include <ctime>
+#include <algorithm>
 using namespace clang;
 
 MacroInfo *Preprocessor::getInfoForMacro(IdentifierInfo *II) const {
@@ -304,6 +305,14 @@ bool Preprocessor::HandleMacroExpandedIdentifier(Token &Identifier,
     // we're done.
     ++NumFastMacroExpanded;
     return false;
+
+  } else if (MI->getNumTokens() == 1 && MI->isObjectLike() &&
+             ExpandObjectLikeMacroChain(Identifier, MI)) {
+    // Otherwise, if this macro is an alias for another object-like macro
+    // ("#define FOO BAR", "#define BAR 42"), the whole chain was collapsed to
+    // its final token.
+    ++NumFastMacroExpanded;
+    return false;
   }
 
   // Start expanding the macro.
@@ -315,6 +324,85 @@ bool Preprocessor::HandleMacroExpandedIdentifier(Token &Identifier,
   return false;
 }
 
+/// ExpandObjectLikeMacroChain - MI is a single-token macro whose replacement
+/// token names another enabled macro.  Walk the chain of single-token
+/// object-like macros it starts and, if it ends in a token that is expanded
+/// literally, return that token in Identifier with the nested expansion
+/// locations a TokenLexer per link would have produced.
+bool Preprocessor::ExpandObjectLikeMacroChain(Token &Identifier,
+                                              MacroInfo *MI) {
+  // Alias chains are normally short; don't bother with long ones.
+  const unsigned MaxChainLength = 8;
+  SmallVector<MacroInfo*, 4> Chain;
+  Chain.push_back(MI);
+
+  while (1) {
+    IdentifierInfo *II =
+      Chain.back()->getReplacementToken(0).getIdentifierInfo();
+    if (II == 0 || !II->hasMacroDefinition())
+      break;
+
+    // A macro that is already being expanded, either by an enclosing
+    // TokenLexer or earlier in this chain, won't be expanded again: the chain
+    // ends at its name.
+    MacroInfo *NextMI = getMacroInfo(II);
+    if (!NextMI->isEnabled() ||
+        std::find(Chain.begin(), Chain.end(), NextMI) != Chain.end())
+      break;
+
+    // Anything other than another single-token object-like macro needs the
+    // general expansion machinery.
+    if (NextMI->isBuiltinMacro() || NextMI->isFunctionLike() ||
+        NextMI->getNumTokens() != 1 || Chain.size() == MaxChainLength)
+      return false;
+
+    Chain.push_back(NextMI);
+  }
+
+  // Propagate the isAtStartOfLine/hasLeadingSpace markers of the macro
+  // identifier to the expanded token.
+  bool isAtStartOfLine = Identifier.isAtStartOfLine();
+  bool hasLeadingSpace = Identifier.hasLeadingSpace();
+
+  // Each link is expanded at the location of the token produced by the
+  // previous one, starting with the original macro identifier.
+  SourceLocation ExpandLoc = Identifier.getLocation();
+  for (unsigned i = 0, e = Chain.size(); i != e; ++i) {
+    MacroInfo *LinkMI = Chain[i];
+
+    // The outermost macro was already noted by HandleMacroExpandedIdentifier.
+    if (i != 0) {
+      markMacroAsUsed(LinkMI);
+      ++NumMacroExpanded;
+      if (Callbacks) Callbacks->MacroExpands(Identifier, LinkMI,
+                                             SourceRange(ExpandLoc));
+    }
+
+    Identifier = LinkMI->getReplacementToken(0);
+    ExpandLoc = SourceMgr.createExpansionLoc(Identifier.getLocation(),
+                                             ExpandLoc, ExpandLoc,
+                                             Identifier.getLength());
+    Identifier.setLocation(ExpandLoc);
+  }
+
+  // Restore the StartOfLine/LeadingSpace markers.
+  Identifier.setFlagValue(Token::StartOfLine , isAtStartOfLine);
+  Identifier.setFlagValue(Token::LeadingSpace, hasLeadingSpace);
+
+  // If the final token names a disabled macro or one from the chain, it must
+  // be marked unexpandable, just as if each link had been lexed from its own
+  // TokenLexer.
+  if (IdentifierInfo *NewII = Identifier.getIdentifierInfo()) {
+    if (MacroInfo *NewMI = getMacroInfo(NewII))
+      if (!NewMI->isEnabled() ||
+          std::find(Chain.begin(), Chain.end(), NewMI) != Chain.end())
+        Identifier.setFlag(Token::DisableExpand);
+  }
+
+  NumFastMacroExpanded += Chain.size() - 1;
+  return true;
+}
+
 /// ReadFunctionLikeMacroArgs - After reading "MACRO" and knowing that the next
 /// token is the '(' of the macro, this method is invoked to read all of the
 /// actual arguments specified for the macro invocation.  This returns null on
@@ -50,34 +50,51 @@ std::pair<PreprocessingRecord::iterator, PreprocessingRecord::iterator>
 PreprocessingRecord::getPreprocessedEntitiesInRange(SourceRange Range) {
   if (Range.isInvalid())
     return std::make_pair(iterator(this, 0), iterator(this, 0));
+
+  if (CachedRangeQuery.Range != Range) {
+    CachedRangeQuery.Result = getPreprocessedEntitiesInRangeSlow(Range);
+    CachedRangeQuery.Range = Range;
+  }
+
+  return std::make_pair(iterator(this, CachedRangeQuery.Result.first),
+                        iterator(this, CachedRangeQuery.Result.second));
+}
+
+/// \brief Computes the [Begin, End) IDs of the preprocessed entities that
+/// \arg Range encompasses. Loaded entities are located through the offsets
+/// recorded by the external source and are not deserialized here; only the
+/// ones the caller ends up dereferencing are.
+std::pair<PreprocessingRecord::PPEntityID, PreprocessingRecord::PPEntityID>
+PreprocessingRecord::getPreprocessedEntitiesInRangeSlow(SourceRange Range) {
   assert(!SourceMgr.isBeforeInTranslationUnit(Range.getEnd(),Range.getBegin()));
 
-  std::pair<unsigned, unsigned>
+  // Loaded entities all come before local ones, so a range that ends in a
+  // loaded location has no local entities, and one that begins in a local
+  // location has no loaded entities.
+  std::pair<unsigned, unsigned> Local(0, 0);
+  if (!SourceMgr.isLoadedSourceLocation(Range.getEnd()))
     Local = findLocalPreprocessedEntitiesInRange(Range);
 
   // Check if range spans local entities.
   if (!ExternalSource || SourceMgr.isLocalSourceLocation(Range.getBegin()))
-    return std::make_pair(iterator(this, Local.first),
-                          iterator(this, Local.second));
+    return std::make_pair(Local.first, Local.second);
 
   std::pair<unsigned, unsigned>
     Loaded = ExternalSource->findPreprocessedEntitiesInRange(Range);
 
   // Check if range spans local entities.
   if (Loaded.first == Loaded.second)
-    return std::make_pair(iterator(this, Local.first),
-                          iterator(this, Local.second));
+    return std::make_pair(Local.first, Local.second);
 
-  unsigned TotalLoaded = LoadedPreprocessedEntities.size();
+  PPEntityID LoadedBegin = getPPEntityID(Loaded.first, /*isLoaded=*/true);
+  PPEntityID LoadedEnd = getPPEntityID(Loaded.second, /*isLoaded=*/true);
 
   // Check if range spans loaded entities.
   if (Local.first == Local.second)
-    return std::make_pair(iterator(this, int(Loaded.first)-TotalLoaded),
-                          iterator(this, int(Loaded.second)-TotalLoaded));
+    return std::make_pair(LoadedBegin, LoadedEnd);
 
   // Range spands loaded and local entities.
-  return std::make_pair(iterator(this, int(Loaded.first)-TotalLoaded),
-                        iterator(this, Local.second));
+  return std::make_pair(LoadedBegin, PPEntityID(Local.second));
 }
 
 std::pair<unsigned, unsigned>
@@ -170,6 +187,8 @@ unsigned PreprocessingRecord::findEndLocalPreprocessedEntity(
 
 void PreprocessingRecord::addPreprocessedEntity(PreprocessedEntity *Entity) {
   assert(Entity);
+  // Inserting an entity may shift the IDs of the ones after it.
+  CachedRangeQuery.Range = SourceRange();
   SourceLocation BeginLoc = Entity->getSourceRange().getBegin();
   
   // Check normal case, this entity begin location is after the previous one.
@@ -205,6 +224,9 @@ void PreprocessingRecord::SetExternalSource(
 }
 
 unsigned PreprocessingRecord::allocateLoadedEntities(unsigned NumEntities) {
+  // Loaded entity IDs are relative to the number of loaded entities.
+  CachedRangeQuery.Range = SourceRange();
+
   unsigned Result = LoadedPreprocessedEntities.size();
   LoadedPreprocessedEntities.resize(LoadedPreprocessedEntities.size() 
                                     + NumEntities);
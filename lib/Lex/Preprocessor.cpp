@@ -126,6 +126,7 @@ void Preprocessor::Initialize(const TargetInfo &Target) {
   NumEnteredSourceFiles = 0;
   NumMacroExpanded = NumFnMacroExpanded = NumBuiltinMacroExpanded = 0;
   NumFastMacroExpanded = NumTokenPaste = NumFastTokenPaste = 0;
+  NumMacroArgsPreExpanded = NumMacroArgsPreExpReused = 0;
   MaxIncludeStackDepth = 0;
   NumSkipped = 0;
   
@@ -236,6 +237,9 @@ void Preprocessor::PrintStats() {
   llvm::errs() << (NumFastTokenPaste+NumTokenPaste)
              << " token paste (##) operations performed, "
              << NumFastTokenPaste << " on the fast path.\n";
+  llvm::errs() << NumMacroArgsPreExpanded
+             << " macro arguments pre-expanded, "
+             << NumMacroArgsPreExpReused << " reused from the cache.\n";
 }
 
 Preprocessor::macro_iterator
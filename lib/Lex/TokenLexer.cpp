@@ -205,9 +205,11 @@ void TokenLexer::ExpandFunctionArguments() {
       const Token *ResultArgToks;
 
       // Only preexpand the argument if it could possibly need it.  This
-      // avoids some work in common cases.
+      // avoids some work in common cases.  If the formal was already used
+      // earlier in the body, reuse its pre-expansion without rescanning it.
       const Token *ArgTok = ActualArgs->getUnexpArgument(ArgNo);
-      if (ActualArgs->ArgNeedsPreexpansion(ArgTok, PP))
+      if (ActualArgs->hasPreExpArgument(ArgNo) ||
+          ActualArgs->ArgNeedsPreexpansion(ArgTok, PP))
         ResultArgToks = &ActualArgs->getPreExpArgument(ArgNo, Macro, PP)[0];
       else
         ResultArgToks = ArgTok;  // Use non-preexpanded tokens.
@@ -17,6 +17,7 @@
 #include "clang/Sema/SemaConsumer.h"
 #include "clang/Sema/ExternalSemaSource.h"
 #include "clang/AST/ASTConsumer.h"
+#include "clang/AST/ASTContext.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/ExternalASTSource.h"
 #include "clang/AST/Stmt.h"
@@ -27,6 +28,22 @@
 
 using namespace clang;
 
+namespace {
+
+/// FinishedDeclsRAII - Lets the ASTContext cache constant folding while the
+/// consumer processes declarations that Sema has finished building.
+class FinishedDeclsRAII {
+  ASTContext &Ctx;
+
+public:
+  explicit FinishedDeclsRAII(ASTContext &Ctx) : Ctx(Ctx) {
+    Ctx.setCanCacheEvaluations(true);
+  }
+  ~FinishedDeclsRAII() { Ctx.setCanCacheEvaluations(false); }
+};
+
+} // end anonymous namespace
+
 //===----------------------------------------------------------------------===//
 // Public interface to the file
 //===----------------------------------------------------------------------===//
@@ -85,13 +102,20 @@ void clang::ParseAST(Sema &S, bool PrintStats) {
     // If we got a null return and something *was* parsed, ignore it.  This
     // is due to a top-level semicolon, an action override, or a parse error
     // skipping something.
-    if (ADecl)
+    if (ADecl) {
+      FinishedDeclsRAII Finished(S.getASTContext());
       Consumer->HandleTopLevelDecl(ADecl.get());
+    }
   };
   // Check for any pending objective-c implementation decl.
-  while ((ADecl = P.FinishPendingObjCActions()))
+  while ((ADecl = P.FinishPendingObjCActions())) {
+    FinishedDeclsRAII Finished(S.getASTContext());
     Consumer->HandleTopLevelDecl(ADecl.get());
-  
+  }
+
+  // Sema is done with the whole translation unit from here on.
+  S.getASTContext().setCanCacheEvaluations(true);
+
   // Process any TopLevelDecls generated by #pragma weak.
   for (SmallVector<Decl*,2>::iterator
        I = S.WeakTopLevelDecls().begin(),
@@ -345,6 +345,12 @@ static void CheckFallThroughForBody(Sema &S, const Decl *D, const Stmt *Body,
 
   // FIXME: Function try block
   if (const CompoundStmt *Compound = dyn_cast<CompoundStmt>(Body)) {
+    // A function returning a value whose body ends in a 'return' cannot
+    // fall off its end; don't build a CFG to prove it.
+    if (!ReturnsVoid && !HasNoReturn && !Compound->body_empty() &&
+        isa<ReturnStmt>(Compound->body_back()))
+      return;
+
     switch (CheckFallThrough(AC)) {
       case UnknownFallThrough:
         break;
@@ -752,12 +758,17 @@ clang::sema::AnalysisBasedWarnings::Policy::Policy() {
 
 clang::sema::AnalysisBasedWarnings::AnalysisBasedWarnings(Sema &s)
   : S(s),
+    SharedContexts(0),
     NumFunctionsAnalyzed(0),
     NumFunctionsWithBadCFGs(0),
+    NumFunctionsWithoutCFGs(0),
     NumCFGBlocks(0),
     MaxCFGBlocksPerFunction(0),
+    NumCFGBytes(0),
+    MaxCFGBytesPerFunction(0),
     NumUninitAnalysisFunctions(0),
     NumUninitAnalysisVariables(0),
+    NumUninitAnalysisVariablesPruned(0),
     MaxUninitAnalysisVariablesPerFunction(0),
     NumUninitAnalysisBlockVisits(0),
     MaxUninitAnalysisBlockVisitsPerFunction(0) {
@@ -781,6 +792,15 @@ static void flushDiagnostics(Sema &S, sema::FunctionScopeInfo *fscope) {
   }
 }
 
+// FIXME: These analyses run on the parsing thread as soon as a body is
+// complete.  Running them on worker threads while parsing continues is not
+// possible yet: they are not read-only with respect to shared state.  CFG
+// construction and the analyses evaluate constant expressions and compute
+// record layouts, which fill ASTContext caches; bodies and redeclarations
+// can be deserialized lazily from an ExternalASTSource; and warnings go
+// through Sema and DiagnosticsEngine, which are not thread-safe.  The
+// diagnostics would also have to be buffered and replayed in source order,
+// and the error check below would have to be made when the body is queued.
 void clang::sema::
 AnalysisBasedWarnings::IssueWarnings(sema::AnalysisBasedWarnings::Policy P,
                                      sema::FunctionScopeInfo *fscope,
@@ -813,14 +833,16 @@ AnalysisBasedWarnings::IssueWarnings(sema::AnalysisBasedWarnings::Policy P,
   const Stmt *Body = D->getBody();
   assert(Body);
 
-  AnalysisContext AC(D, 0);
+  AnalysisContext LocalAC(D, 0);
+  CFG::BuildOptions &Options = LocalAC.getCFGBuildOptions();
 
   // Don't generate EH edges for CallExprs as we'd like to avoid the n^2
   // explosion for destrutors that can result and the compile time hit.
-  AC.getCFGBuildOptions().PruneTriviallyFalseEdges = true;
-  AC.getCFGBuildOptions().AddEHEdges = false;
-  AC.getCFGBuildOptions().AddInitializers = true;
-  AC.getCFGBuildOptions().AddImplicitDtors = true;
+  Options.PruneTriviallyFalseEdges = true;
+  Options.AddEHEdges = false;
+  Options.AddInitializers = true;
+  Options.AddImplicitDtors = true;
+  Options.ScratchAllocator = &CFGScratch;
   
   // Force that certain expressions appear as CFGElements in the CFG.  This
   // is used to speed up various analyses.
@@ -830,10 +852,10 @@ AnalysisBasedWarnings::IssueWarnings(sema::AnalysisBasedWarnings::Policy P,
   // appropriately.  This is essentially a layering violation.
   if (P.enableCheckUnreachable) {
     // Unreachable code analysis requires a linearized CFG.
-    AC.getCFGBuildOptions().setAllAlwaysAdd();
+    Options.setAllAlwaysAdd();
   }
   else {
-    AC.getCFGBuildOptions()
+    Options
       .setAlwaysAdd(Stmt::BinaryOperatorClass)
       .setAlwaysAdd(Stmt::BlockExprClass)
       .setAlwaysAdd(Stmt::CStyleCastExprClass)
@@ -843,7 +865,12 @@ AnalysisBasedWarnings::IssueWarnings(sema::AnalysisBasedWarnings::Policy P,
   }
 
   // Construct the analysis context with the specified CFG build options.
-  
+  // If a later client wants to reuse our CFG and its own can serve the
+  // analyses below, build that one instead.
+  AnalysisContext *SharedAC =
+    SharedContexts ? SharedContexts->getSharedContext(D, Options) : 0;
+  AnalysisContext &AC = SharedAC ? *SharedAC : LocalAC;
+
   // Emit delayed diagnostics.
   if (!fscope->PossiblyUnreachableDiags.empty()) {
     bool analyzed = false;
@@ -911,13 +938,20 @@ AnalysisBasedWarnings::IssueWarnings(sema::AnalysisBasedWarnings::Policy P,
       != DiagnosticsEngine::Ignored ||
       Diags.getDiagnosticLevel(diag::warn_maybe_uninit_var, D->getLocStart())
       != DiagnosticsEngine::Ignored) {
-    if (CFG *cfg = AC.getCFG()) {
+    // Without variables to track there is nothing to report, so don't build
+    // the CFG just for this.
+    CFG *cfg = 0;
+    if (hasTrackedVariables(*cast<DeclContext>(D)))
+      cfg = AC.getCFG();
+    if (cfg) {
       UninitValsDiagReporter reporter(S);
       UninitVariablesAnalysisStats stats;
       std::memset(&stats, 0, sizeof(UninitVariablesAnalysisStats));
       runUninitializedVariablesAnalysis(*cast<DeclContext>(D), *cfg, AC,
                                         reporter, stats);
 
+      if (S.CollectStats)
+        NumUninitAnalysisVariablesPruned += stats.NumVariablesPruned;
       if (S.CollectStats && stats.NumVariablesAnalyzed > 0) {
         ++NumUninitAnalysisFunctions;
         NumUninitAnalysisVariables += stats.NumVariablesAnalyzed;
@@ -941,9 +975,14 @@ AnalysisBasedWarnings::IssueWarnings(sema::AnalysisBasedWarnings::Policy P,
       NumCFGBlocks += cfg->getNumBlockIDs();
       MaxCFGBlocksPerFunction = std::max(MaxCFGBlocksPerFunction,
                                          cfg->getNumBlockIDs());
+      size_t Bytes = cfg->getAllocator().getTotalMemory();
+      NumCFGBytes += Bytes;
+      MaxCFGBytesPerFunction = std::max(MaxCFGBytesPerFunction, Bytes);
     } else {
       ++NumFunctionsWithBadCFGs;
     }
+  } else if (S.CollectStats) {
+    ++NumFunctionsWithoutCFGs;
   }
 }
 
@@ -955,11 +994,16 @@ void clang::sema::AnalysisBasedWarnings::PrintStats() const {
       !NumCFGsBuilt ? 0 : NumCFGBlocks/NumCFGsBuilt;
   llvm::errs() << NumFunctionsAnalyzed << " functions analyzed ("
                << NumFunctionsWithBadCFGs << " w/o CFGs).\n"
+               << "  " << NumFunctionsWithoutCFGs
+               << " functions needed no CFG.\n"
                << "  " << NumCFGBlocks << " CFG blocks built.\n"
                << "  " << AvgCFGBlocksPerFunction
                << " average CFG blocks per function.\n"
                << "  " << MaxCFGBlocksPerFunction
-               << " max CFG blocks per function.\n";
+               << " max CFG blocks per function.\n"
+               << "  " << NumCFGBytes << " bytes allocated for CFGs.\n"
+               << "  " << MaxCFGBytesPerFunction
+               << " max bytes allocated for a CFG.\n";
 
   unsigned AvgUninitVariablesPerFunction = !NumUninitAnalysisFunctions ? 0
       : NumUninitAnalysisVariables/NumUninitAnalysisFunctions;
@@ -968,6 +1012,8 @@ void clang::sema::AnalysisBasedWarnings::PrintStats() const {
   llvm::errs() << NumUninitAnalysisFunctions
                << " functions analyzed for uninitialiazed variables\n"
                << "  " << NumUninitAnalysisVariables << " variables analyzed.\n"
+               << "  " << NumUninitAnalysisVariablesPruned
+               << " variables pruned without analysis.\n"
                << "  " << AvgUninitVariablesPerFunction
                << " average variables per function.\n"
                << "  " << MaxUninitAnalysisVariablesPerFunction
@@ -16,6 +16,7 @@
 #include "clang/Sema/Scope.h"
 #include "clang/AST/Decl.h"
 #include "clang/Basic/LangOptions.h"
+#include <algorithm>
 
 using namespace clang;
 
@@ -66,18 +67,69 @@ public:
 /// RemoveDecl - Remove the decl from the scope chain.
 /// The decl must already be part of the decl chain.
 void IdentifierResolver::IdDeclInfo::RemoveDecl(NamedDecl *D) {
-  for (DeclsTy::iterator I = Decls.end(); I != Decls.begin(); --I) {
-    if (D == *(I-1)) {
-      Decls.erase(I-1);
-      return;
+  if (tryRemoveDecl(D))
+    return;
+
+  llvm_unreachable("Didn't find this decl on its identifier's chain!");
+}
+
+bool IdentifierResolver::IdDeclInfo::tryRemoveDecl(NamedDecl *D) {
+  if (Decls.size() < IndexThreshold) {
+    for (DeclsTy::iterator I = Decls.end(); I != Decls.begin(); --I) {
+      if (D == *(I-1)) {
+        Decls.erase(I-1);
+        invalidateIndex();
+        return true;
+      }
     }
+
+    return false;
   }
 
-  llvm_unreachable("Didn't find this decl on its identifier's chain!");
+  if (!Index) {
+    Index = new IndexTy;
+    for (unsigned I = 0, N = Decls.size(); I != N; ++I)
+      if (Decls[I])
+        (*Index)[Decls[I]] = I;
+  }
+
+  IndexTy::iterator Pos = Index->find(D);
+  if (Pos == Index->end())
+    return false;
+
+  // Leave a null slot behind rather than shifting the rest of the chain.
+  Decls[Pos->second] = 0;
+  Index->erase(Pos);
+  ++NumRemoved;
+  while (!Decls.empty() && !Decls.back()) {
+    Decls.pop_back();
+    --NumRemoved;
+  }
+  if (NumRemoved > Decls.size() / 2)
+    compact();
+  return true;
+}
+
+void IdentifierResolver::IdDeclInfo::compact() {
+  Decls.erase(std::remove(Decls.begin(), Decls.end(), (NamedDecl *)0),
+              Decls.end());
+  NumRemoved = 0;
+  invalidateIndex();
 }
 
 bool
 IdentifierResolver::IdDeclInfo::ReplaceDecl(NamedDecl *Old, NamedDecl *New) {
+  if (Index) {
+    IndexTy::iterator Pos = Index->find(Old);
+    if (Pos == Index->end())
+      return false;
+    unsigned Slot = Pos->second;
+    Index->erase(Pos);
+    Decls[Slot] = New;
+    (*Index)[New] = Slot;
+    return true;
+  }
+
   for (DeclsTy::iterator I = Decls.end(); I != Decls.begin(); --I) {
     if (Old == *(I-1)) {
       *(I - 1) = New;
@@ -88,7 +140,6 @@ IdentifierResolver::IdDeclInfo::ReplaceDecl(NamedDecl *Old, NamedDecl *New) {
   return false;
 }
 
-
 //===----------------------------------------------------------------------===//
 // IdentifierResolver Implementation
 //===----------------------------------------------------------------------===//
@@ -227,6 +278,26 @@ void IdentifierResolver::RemoveDecl(NamedDecl *D) {
   return toIdDeclInfo(Ptr)->RemoveDecl(D);
 }
 
+bool IdentifierResolver::tryRemoveDecl(NamedDecl *D) {
+  assert(D && "null param passed");
+  DeclarationName Name = D->getDeclName();
+  void *Ptr = Name.getFETokenInfo<void>();
+
+  if (!Ptr)
+    return false;
+
+  if (isDeclPtr(Ptr)) {
+    if (Ptr != D)
+      return false;
+    Name.setFETokenInfo(NULL);
+  } else if (!toIdDeclInfo(Ptr)->tryRemoveDecl(D))
+    return false;
+
+  if (IdentifierInfo *II = Name.getAsIdentifierInfo())
+    II->setIsFromAST(false);
+  return true;
+}
+
 bool IdentifierResolver::ReplaceDecl(NamedDecl *Old, NamedDecl *New) {
   assert(Old->getDeclName() == New->getDeclName() &&
          "Cannot replace a decl with another decl of a different name");
@@ -262,9 +333,11 @@ IdentifierResolver::begin(DeclarationName Name) {
 
   IdDeclInfo *IDI = toIdDeclInfo(Ptr);
 
-  IdDeclInfo::DeclsTy::iterator I = IDI->decls_end();
-  if (I != IDI->decls_begin())
-    return iterator(I-1);
+  // Skip the slots of removed decls.
+  for (IdDeclInfo::DeclsTy::iterator I = IDI->decls_end();
+       I != IDI->decls_begin(); --I)
+    if (*(I-1))
+      return iterator(I-1);
   // No decls found.
   return end();
 }
@@ -322,9 +395,13 @@ void IdentifierResolver::iterator::incrementSlowCase() {
   assert(!isDeclPtr(InfoPtr) && "Decl with wrong id ?");
   IdDeclInfo *Info = toIdDeclInfo(InfoPtr);
 
-  BaseIter I = getIterator();
-  if (I != Info->decls_begin())
-    *this = iterator(I-1);
-  else // No more decls.
-    *this = iterator();
+  // Skip the slots of removed decls.
+  for (BaseIter I = getIterator(); I != Info->decls_begin(); --I) {
+    if (*(I-1)) {
+      *this = iterator(I-1);
+      return;
+    }
+  }
+  // No more decls.
+  *this = iterator();
 }
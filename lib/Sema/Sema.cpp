@@ -20,6 +20,7 @@
 #include "llvm/ADT/APFloat.h"
 #include "clang/Sema/CXXFieldCollector.h"
 #include "clang/Sema/TemplateDeduction.h"
+#include "clang/Sema/TemplateInstantiationProfiler.h"
 #include "clang/Sema/ExternalSemaSource.h"
 #include "clang/Sema/ObjCMethodList.h"
 #include "clang/Sema/PrettyDeclStackTrace.h"
@@ -103,7 +104,9 @@ Sema::Sema(Preprocessor &pp, ASTContext &ctxt, ASTConsumer &consumer,
     ObjCShouldCallSuperDealloc(false),
     ObjCShouldCallSuperFinalize(false),
     TUKind(TUKind),
-    NumSFINAEErrors(0), SuppressAccessChecking(false), 
+    NumSFINAEErrors(0), NumOverloadConversionsComputed(0),
+    NumOverloadConversionsReused(0), NumOverloadConversionsPrefiltered(0),
+    SuppressAccessChecking(false), 
     AccessCheckingSFINAE(false), InNonInstantiationSFINAEContext(false),
     NonInstantiationEntries(0), ArgumentPackSubstitutionIndex(-1),
     CurrentInstantiationScope(0), TyposCorrected(0),
@@ -220,6 +223,14 @@ bool Sema::makeUnavailableInSystemHeader(SourceLocation loc,
   return true;
 }
 
+void Sema::enableTemplateInstantiationProfiling(bool RecordTrace) {
+  assert(ActiveTemplateInstantiations.empty() &&
+         "Can't start profiling in the middle of an instantiation");
+  InstantiationProfiler.reset(
+                      new sema::TemplateInstantiationProfiler(Context,
+                                                              RecordTrace));
+}
+
 ASTMutationListener *Sema::getASTMutationListener() const {
   return getASTConsumer().GetASTMutationListener();
 }
@@ -228,6 +239,10 @@ ASTMutationListener *Sema::getASTMutationListener() const {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  llvm::errs() << NumOverloadConversionsComputed
+               << " overload candidate argument conversions computed, "
+               << NumOverloadConversionsReused << " reused, "
+               << NumOverloadConversionsPrefiltered << " rejected early.\n";
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
@@ -438,6 +453,13 @@ void Sema::ActOnEndOfTranslationUnit() {
     // future, we either need to be able to filter the results of name lookup
     // or we need to perform template instantiations earlier.
     PerformPendingInstantiations();
+  } else if (TUKind == TU_Prefix && LangOpts.PCHInstantiateTemplates) {
+    // Instantiate whatever the precompiled header itself requires now, so
+    // the instantiations are stored in the PCH and every translation unit
+    // that includes it can reuse them rather than instantiating them again.
+    // This moves the point of instantiation to the end of the PCH; as noted
+    // above, we don't model points of instantiation precisely anyway.
+    PerformPendingInstantiations();
   }
   
   // Remove file scoped decls that turned out to be used.
@@ -903,15 +903,23 @@ void Sema::PushOnScopeChains(NamedDecl *D, Scope *S, bool AddToContext) {
     return;
 
   // If this replaces anything in the current scope, 
-  IdentifierResolver::iterator I = IdResolver.begin(D->getDeclName()),
-                               IEnd = IdResolver.end();
-  for (; I != IEnd; ++I) {
-    if (S->isDeclScope(*I) && D->declarationReplaces(*I)) {
-      S->RemoveDecl(*I);
-      IdResolver.RemoveDecl(*I);
-
-      // Should only need to replace one decl.
-      break;
+  NamedDecl *Prev = 0;
+  if (D->replacesOnlyPreviousDeclaration(Prev)) {
+    // Don't walk the identifier chain: it holds every overload of this name
+    // that is visible here, which is a lot in generated code.
+    if (Prev && S->isDeclScope(Prev) && IdResolver.tryRemoveDecl(Prev))
+      S->RemoveDecl(Prev);
+  } else {
+    for (IdentifierResolver::iterator I = IdResolver.begin(D->getDeclName()),
+                                      IEnd = IdResolver.end();
+         I != IEnd; ++I) {
+      if (S->isDeclScope(*I) && D->declarationReplaces(*I)) {
+        S->RemoveDecl(*I);
+        IdResolver.RemoveDecl(*I);
+
+        // Should only need to replace one decl.
+        break;
+      }
     }
   }
 
@@ -921,7 +929,9 @@ void Sema::PushOnScopeChains(NamedDecl *D, Scope *S, bool AddToContext) {
     // Implicitly-generated labels may end up getting generated in an order that
     // isn't strictly lexical, which breaks name lookup. Be careful to insert
     // the label at the appropriate place in the identifier chain.
-    for (I = IdResolver.begin(D->getDeclName()); I != IEnd; ++I) {
+    IdentifierResolver::iterator I = IdResolver.begin(D->getDeclName()),
+                                 IEnd = IdResolver.end();
+    for (; I != IEnd; ++I) {
       DeclContext *IDC = (*I)->getLexicalDeclContext()->getRedeclContext();
       if (IDC == CurContext) {
         if (!S->isDeclScope(*I))
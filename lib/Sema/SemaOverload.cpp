@@ -540,6 +540,7 @@ OverloadCandidate::DeductionFailureInfo::getSecondArg() {
 void OverloadCandidateSet::clear() {
   inherited::clear();
   Functions.clear();
+  Conversions.clear();
 }
 
 // IsOverload - Determine whether the given New declaration is an
@@ -3717,6 +3718,63 @@ TryCopyInitialization(Sema &S, Expr *From, QualType ToType,
                                AllowObjCWritebackConversion);
 }
 
+/// isObviouslyBadConversion - Determine, from the kinds of the types involved
+/// alone, whether copy-initializing a non-reference parameter of type ToType
+/// from From certainly fails.  This recognizes conversions from pointers,
+/// arrays and functions to arithmetic types other than bool, which are common
+/// among the candidates of large overload sets such as operator<< and can
+/// never be formed implicitly in C++: neither type is a class type, so no
+/// user-defined conversion applies either.
+static bool isObviouslyBadConversion(Sema &S, Expr *From, QualType ToType) {
+  if (!S.getLangOptions().CPlusPlus || ToType->isReferenceType())
+    return false;
+
+  QualType FromType = From->getType();
+  if (FromType->isDependentType() || ToType->isDependentType())
+    return false;
+
+  if (!ToType->isArithmeticType() || ToType->isBooleanType())
+    return false;
+
+  return FromType->isPointerType() || FromType->isArrayType() ||
+         FromType->isFunctionType() || FromType->isMemberPointerType() ||
+         FromType->isBlockPointerType() || FromType->isObjCObjectPointerType();
+}
+
+/// TryCopyInitializationForCandidate - Compute the implicit conversion
+/// sequence for passing From to a parameter of type ToType of a candidate in
+/// CandidateSet, as TryCopyInitialization does in overload resolution.
+/// Conversions that obviously fail are rejected without being computed, and
+/// sequences already computed for another candidate of the set are reused.
+static ImplicitConversionSequence
+TryCopyInitializationForCandidate(Sema &S, OverloadCandidateSet &CandidateSet,
+                                  Expr *From, QualType ToType,
+                                  bool SuppressUserConversions) {
+  if (isObviouslyBadConversion(S, From, ToType)) {
+    ++S.NumOverloadConversionsPrefiltered;
+    ImplicitConversionSequence ICS;
+    ICS.setBad(BadConversionSequence::no_conversion, From, ToType);
+    return ICS;
+  }
+
+  if (const ImplicitConversionSequence *Cached
+        = CandidateSet.getCachedConversion(From, ToType,
+                                           SuppressUserConversions)) {
+    ++S.NumOverloadConversionsReused;
+    return *Cached;
+  }
+
+  ++S.NumOverloadConversionsComputed;
+  ImplicitConversionSequence ICS
+    = TryCopyInitialization(S, From, ToType,
+                            SuppressUserConversions,
+                            /*InOverloadResolution=*/true,
+                            /*AllowObjCWritebackConversion=*/
+                              S.getLangOptions().ObjCAutoRefCount);
+  CandidateSet.cacheConversion(From, ToType, SuppressUserConversions, ICS);
+  return ICS;
+}
+
 static bool TryCopyInitialization(const CanQualType FromQTy,
                                   const CanQualType ToQTy,
                                   Sema &S,
@@ -4281,11 +4339,9 @@ Sema::AddOverloadCandidate(FunctionDecl *Function,
       // parameter of F.
       QualType ParamType = Proto->getArgType(ArgIdx);
       Candidate.Conversions[ArgIdx]
-        = TryCopyInitialization(*this, Args[ArgIdx], ParamType,
-                                SuppressUserConversions,
-                                /*InOverloadResolution=*/true,
-                                /*AllowObjCWritebackConversion=*/
-                                  getLangOptions().ObjCAutoRefCount);
+        = TryCopyInitializationForCandidate(*this, CandidateSet,
+                                            Args[ArgIdx], ParamType,
+                                            SuppressUserConversions);
       if (Candidate.Conversions[ArgIdx].isBad()) {
         Candidate.Viable = false;
         Candidate.FailureKind = ovl_fail_bad_conversion;
@@ -4456,11 +4512,9 @@ Sema::AddMethodCandidate(CXXMethodDecl *Method, DeclAccessPair FoundDecl,
       // parameter of F.
       QualType ParamType = Proto->getArgType(ArgIdx);
       Candidate.Conversions[ArgIdx + 1]
-        = TryCopyInitialization(*this, Args[ArgIdx], ParamType,
-                                SuppressUserConversions,
-                                /*InOverloadResolution=*/true,
-                                /*AllowObjCWritebackConversion=*/
-                                  getLangOptions().ObjCAutoRefCount);
+        = TryCopyInitializationForCandidate(*this, CandidateSet,
+                                            Args[ArgIdx], ParamType,
+                                            SuppressUserConversions);
       if (Candidate.Conversions[ArgIdx + 1].isBad()) {
         Candidate.Viable = false;
         Candidate.FailureKind = ovl_fail_bad_conversion;
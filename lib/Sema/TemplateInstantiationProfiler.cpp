@@ -0,0 +1,200 @@
+//===--- TemplateInstantiationProfiler.cpp - Profile instantiations -------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements TemplateInstantiationProfiler, which accounts the time
+// and AST memory spent in each entry of Sema's template instantiation stack.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Sema/TemplateInstantiationProfiler.h"
+#include "clang/Sema/Sema.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+using namespace clang;
+using namespace sema;
+
+typedef Sema::ActiveTemplateInstantiation ActiveInst;
+
+static double getCurrentWallTime() {
+  return llvm::TimeRecord::getCurrentTime().getWallTime();
+}
+
+TemplateInstantiationProfiler::TemplateInstantiationProfiler(ASTContext &Context,
+                                                             bool RecordTrace)
+  : Context(Context), RecordTrace(RecordTrace),
+    ProfileStartTime(getCurrentWallTime()) { }
+
+void TemplateInstantiationProfiler::startInstantiation(unsigned Kind,
+                                                       uintptr_t Entity) {
+  std::pair<uintptr_t, unsigned> Key(Entity, Kind);
+  llvm::DenseMap<std::pair<uintptr_t, unsigned>, unsigned>::iterator Known
+    = EntryIndices.find(Key);
+  unsigned Index;
+  if (Known != EntryIndices.end())
+    Index = Known->second;
+  else {
+    Index = Entries.size();
+    Entries.push_back(Entry(Kind, Entity));
+    EntryIndices[Key] = Index;
+  }
+
+  // Every active instantiation gains a nested one.
+  for (unsigned I = 0, N = Stack.size(); I != N; ++I)
+    ++Stack[I].Nested;
+
+  Frame F;
+  F.EntryIndex = Index;
+  F.StartTime = getCurrentWallTime();
+  F.StartBytes = Context.getASTAllocatedMemory();
+  F.Nested = 0;
+  Stack.push_back(F);
+}
+
+void TemplateInstantiationProfiler::finishInstantiation() {
+  assert(!Stack.empty() && "Unbalanced template instantiation profiling");
+  Frame F = Stack.pop_back_val();
+  double Duration = getCurrentWallTime() - F.StartTime;
+
+  // Entities instantiated recursively (e.g., through repeated deduction of
+  // the same function template) are only charged for the outermost entry, so
+  // that inclusive times don't add up to more than the total.
+  Entry &E = Entries[F.EntryIndex];
+  ++E.Count;
+  bool IsOutermost = true;
+  for (unsigned I = 0, N = Stack.size(); I != N; ++I)
+    if (Stack[I].EntryIndex == F.EntryIndex) {
+      IsOutermost = false;
+      break;
+    }
+  if (IsOutermost) {
+    E.WallTime += Duration;
+    E.BytesAllocated += Context.getASTAllocatedMemory() - F.StartBytes;
+    E.NestedInstantiations += F.Nested;
+  }
+
+  if (RecordTrace) {
+    TraceEvent Event;
+    Event.EntryIndex = F.EntryIndex;
+    Event.StartTime = F.StartTime - ProfileStartTime;
+    Event.Duration = Duration;
+    TraceEvents.push_back(Event);
+  }
+}
+
+std::string
+TemplateInstantiationProfiler::getEntryName(const Entry &E) const {
+  std::string Name;
+  switch (E.Kind) {
+  case ActiveInst::TemplateInstantiation:
+    break;
+  case ActiveInst::DefaultTemplateArgumentInstantiation:
+    Name = "default template argument of ";
+    break;
+  case ActiveInst::DefaultFunctionArgumentInstantiation:
+    Name = "default function argument ";
+    break;
+  case ActiveInst::ExplicitTemplateArgumentSubstitution:
+    Name = "explicit template argument substitution into ";
+    break;
+  case ActiveInst::DeducedTemplateArgumentSubstitution:
+    Name = "deduced template argument substitution into ";
+    break;
+  case ActiveInst::PriorTemplateArgumentSubstitution:
+    Name = "prior template argument substitution into ";
+    break;
+  case ActiveInst::DefaultTemplateArgumentChecking:
+    Name = "checking default template argument ";
+    break;
+  }
+
+  Decl *D = reinterpret_cast<Decl *>(E.Entity);
+  if (NamedDecl *ND = dyn_cast_or_null<NamedDecl>(D))
+    ND->getNameForDiagnostic(Name, Context.getPrintingPolicy(), true);
+  else
+    Name += "<unnamed>";
+  return Name;
+}
+
+namespace {
+  /// \brief Orders entries by decreasing time, then by decreasing memory.
+  struct EntryCostGreater {
+    const std::vector<TemplateInstantiationProfiler::Entry> &Entries;
+
+    EntryCostGreater(
+        const std::vector<TemplateInstantiationProfiler::Entry> &Entries)
+      : Entries(Entries) { }
+
+    bool operator()(unsigned LHS, unsigned RHS) const {
+      const TemplateInstantiationProfiler::Entry &L = Entries[LHS];
+      const TemplateInstantiationProfiler::Entry &R = Entries[RHS];
+      if (L.WallTime != R.WallTime)
+        return L.WallTime > R.WallTime;
+      if (L.BytesAllocated != R.BytesAllocated)
+        return L.BytesAllocated > R.BytesAllocated;
+      return LHS < RHS;
+    }
+  };
+}
+
+void TemplateInstantiationProfiler::printReport(raw_ostream &OS) const {
+  std::vector<unsigned> Order;
+  for (unsigned I = 0, N = Entries.size(); I != N; ++I)
+    Order.push_back(I);
+  std::sort(Order.begin(), Order.end(), EntryCostGreater(Entries));
+
+  OS << "\n*** Template Instantiation Profile:\n";
+  OS << Entries.size() << " entities instantiated or substituted into.\n";
+  OS << "  Wall Time     Bytes   Count  Nested  Name\n";
+  for (unsigned I = 0, N = Order.size(); I != N; ++I) {
+    const Entry &E = Entries[Order[I]];
+    OS << llvm::format("%11.6f", E.WallTime)
+       << llvm::format("%10llu", (unsigned long long)E.BytesAllocated)
+       << llvm::format("%8u", E.Count)
+       << llvm::format("%8u", E.NestedInstantiations)
+       << "  " << getEntryName(E) << '\n';
+  }
+}
+
+/// \brief Write Str as a JSON string literal.
+static void writeJSONString(raw_ostream &OS, StringRef Str) {
+  OS << '"';
+  for (unsigned I = 0, N = Str.size(); I != N; ++I) {
+    unsigned char C = Str[I];
+    if (C == '"' || C == '\\')
+      OS << '\\' << C;
+    else if (C < 0x20)
+      OS << llvm::format("\\u%04x", C);
+    else
+      OS << C;
+  }
+  OS << '"';
+}
+
+void TemplateInstantiationProfiler::writeTraceEvents(raw_ostream &OS) const {
+  OS << "{ \"traceEvents\": [\n";
+  for (unsigned I = 0, N = TraceEvents.size(); I != N; ++I) {
+    const TraceEvent &Event = TraceEvents[I];
+    const Entry &E = Entries[Event.EntryIndex];
+    OS << "  { \"name\": ";
+    writeJSONString(OS, getEntryName(E));
+    OS << ", \"cat\": \"template\", \"ph\": \"X\", \"pid\": 1, \"tid\": 0"
+       << ", \"ts\": " << llvm::format("%.3f", Event.StartTime * 1e6)
+       << ", \"dur\": " << llvm::format("%.3f", Event.Duration * 1e6)
+       << " }";
+    if (I + 1 != N)
+      OS << ',';
+    OS << '\n';
+  }
+  OS << "] }\n";
+}
@@ -14,6 +14,7 @@
 #include "ASTCommon.h"
 #include "clang/Serialization/ASTDeserializationListener.h"
 #include "clang/Basic/IdentifierTable.h"
+#include "clang/Basic/TargetInfo.h"
 #include "llvm/ADT/StringExtras.h"
 
 using namespace clang;
@@ -72,3 +73,45 @@ unsigned serialization::ComputeHash(Selector Sel) {
       R = llvm::HashString(II->getName(), R);
   return R;
 }
+
+void
+serialization::AddRecordLayoutSignature(const ASTContext &Context,
+                                        SmallVectorImpl<uint64_t> &Record) {
+  const TargetInfo &Target = Context.getTargetInfo();
+  Record.push_back(llvm::HashString(Target.getTargetDescription()));
+  Record.push_back(Target.getCXXABI());
+  Record.push_back(Target.getPointerWidth(0));
+  Record.push_back(Target.getPointerAlign(0));
+  Record.push_back(Target.getBoolWidth());
+  Record.push_back(Target.getBoolAlign());
+  Record.push_back(Target.getCharWidth());
+  Record.push_back(Target.getShortWidth());
+  Record.push_back(Target.getShortAlign());
+  Record.push_back(Target.getIntWidth());
+  Record.push_back(Target.getIntAlign());
+  Record.push_back(Target.getLongWidth());
+  Record.push_back(Target.getLongAlign());
+  Record.push_back(Target.getLongLongWidth());
+  Record.push_back(Target.getLongLongAlign());
+  Record.push_back(Target.getWCharWidth());
+  Record.push_back(Target.getWCharAlign());
+  Record.push_back(Target.getHalfWidth());
+  Record.push_back(Target.getHalfAlign());
+  Record.push_back(Target.getFloatWidth());
+  Record.push_back(Target.getFloatAlign());
+  Record.push_back(Target.getDoubleWidth());
+  Record.push_back(Target.getDoubleAlign());
+  Record.push_back(Target.getLongDoubleWidth());
+  Record.push_back(Target.getLongDoubleAlign());
+  Record.push_back(Target.getLargeArrayMinWidth());
+  Record.push_back(Target.getLargeArrayAlign());
+  Record.push_back(Target.useBitFieldTypeAlignment());
+  Record.push_back(Target.useZeroLengthBitfieldAlignment());
+  Record.push_back(Target.getZeroLengthBitfieldBoundary());
+
+  const LangOptions &LangOpts = Context.getLangOptions();
+  Record.push_back(LangOpts.PackStruct);
+  Record.push_back(LangOpts.MSBitfields);
+  Record.push_back(LangOpts.ShortWChar);
+  Record.push_back(LangOpts.ShortEnums);
+}
@@ -57,6 +57,14 @@ TypeID MakeTypeID(ASTContext &Context, QualType T, IdxForTypeTy IdxForType) {
 
 unsigned ComputeHash(Selector Sel);
 
+/// \brief Append the target and language properties that record layouts
+/// depend on to \p Record.
+///
+/// Stored record layouts are only reused when the signature of the current
+/// compilation matches the one they were computed with.
+void AddRecordLayoutSignature(const ASTContext &Context,
+                              SmallVectorImpl<uint64_t> &Record);
+
 } // namespace serialization
 
 } // namespace clang
@@ -26,6 +26,7 @@
 #include "clang/AST/Expr.h"
 #include "clang/AST/ExprCXX.h"
 #include "clang/AST/NestedNameSpecifier.h"
+#include "clang/AST/RecordLayout.h"
 #include "clang/AST/Type.h"
 #include "clang/AST/TypeLocVisitor.h"
 #include "clang/Lex/MacroInfo.h"
@@ -1538,6 +1539,33 @@ void ASTReader::MaybeAddSystemRootToFilename(std::string &Filename) {
   Filename.insert(Filename.begin(), isysroot.begin(), isysroot.end());
 }
 
+/// \brief Advance \p Idx past the record layout that starts there within a
+/// RECORD_LAYOUTS record.
+///
+/// \returns false if the record is malformed.
+static bool skipRecordLayout(const SmallVectorImpl<uint64_t> &Record,
+                             unsigned &Idx) {
+  // Record ID, size, alignment, data size, then the field offsets.
+  Idx += 4;
+  if (Idx >= Record.size())
+    return false;
+  Idx += Record[Idx] + 1;
+  if (Idx >= Record.size())
+    return false;
+  if (!Record[Idx++])
+    return true;
+
+  // Sizes, vbptr offset and primary base, then the base and virtual base
+  // offsets.
+  Idx += 6;
+  for (unsigned I = 0; I != 2; ++I) {
+    if (Idx >= Record.size())
+      return false;
+    Idx += 2 * Record[Idx] + 1;
+  }
+  return Idx <= Record.size();
+}
+
 ASTReader::ASTReadResult
 ASTReader::ReadASTBlock(Module &F) {
   llvm::BitstreamCursor &Stream = F.Stream;
@@ -2183,6 +2211,34 @@ ASTReader::ReadASTBlock(Module &F) {
       break;
     }
         
+    case RECORD_LAYOUTS: {
+      if (!F.RecordLayouts.empty()) {
+        Error("duplicate RECORD_LAYOUTS record in AST file");
+        return Failure;
+      }
+
+      // Only find where each layout starts; the layouts themselves are
+      // decoded when requested. They follow the properties of the target
+      // they were computed for, which are preceded by their number.
+      F.RecordLayouts.swap(Record);
+      if (F.RecordLayouts.empty() ||
+          F.RecordLayouts[0] >= F.RecordLayouts.size()) {
+        Error("invalid RECORD_LAYOUTS record in AST file");
+        return Failure;
+      }
+      unsigned Idx = F.RecordLayouts[0] + 1;
+      while (Idx < F.RecordLayouts.size()) {
+        serialization::GlobalDeclID ID
+          = getGlobalDeclID(F, F.RecordLayouts[Idx]);
+        RecordLayoutOffsets[ID] = std::make_pair(&F, Idx);
+        if (!skipRecordLayout(F.RecordLayouts, Idx)) {
+          Error("invalid RECORD_LAYOUTS record in AST file");
+          return Failure;
+        }
+      }
+      break;
+    }
+
     case CXX_BASE_SPECIFIER_OFFSETS: {
       if (F.LocalNumCXXBaseSpecifiers != 0) {
         Error("duplicate CXX_BASE_SPECIFIER_OFFSETS record in AST file");
@@ -2970,11 +3026,11 @@ ASTReader::findBeginPreprocessedEntity(SourceLocation BLoc) const {
       Count = Half;
   }
 
-  if (PPI == pp_end)
+  if (First == pp_end)
     return findNextPreprocessedEntity(SLocMapI);
 
   return getGlobalPreprocessedEntityID(M,
-                                 M.BasePreprocessedEntityID + (PPI - pp_begin));
+                               M.BasePreprocessedEntityID + (First - pp_begin));
 }
 
 /// \brief Returns the first preprocessed entity ID that begins after \arg ELoc.
@@ -3964,6 +4020,66 @@ CXXBaseSpecifier *ASTReader::GetExternalCXXBaseSpecifiers(uint64_t Offset) {
   return Bases;
 }
 
+const ASTRecordLayout *ASTReader::GetExternalRecordLayout(const RecordDecl *D) {
+  PendingRecordLayoutMap::iterator Pos = PendingRecordLayouts.find(D);
+  if (Pos == PendingRecordLayouts.end())
+    return 0;
+  Module &F = *Pos->second.first;
+  unsigned Idx = Pos->second.second;
+  PendingRecordLayouts.erase(Pos);
+
+  // The layout is only valid for the target and language options it was
+  // computed with. The signature of this compilation is only formed once the
+  // target is known, which may be after the AST file was loaded.
+  const SmallVectorImpl<uint64_t> &Record = F.RecordLayouts;
+  if (RecordLayoutSignature.empty())
+    AddRecordLayoutSignature(Context, RecordLayoutSignature);
+  if (Record[0] != RecordLayoutSignature.size() ||
+      !std::equal(RecordLayoutSignature.begin(), RecordLayoutSignature.end(),
+                  Record.begin() + 1))
+    return 0;
+
+  ++NumRecordLayoutsRead;
+  ++Idx; // The ID of the record itself.
+  CharUnits Size = CharUnits::fromQuantity(Record[Idx++]);
+  CharUnits Alignment = CharUnits::fromQuantity(Record[Idx++]);
+  CharUnits DataSize = CharUnits::fromQuantity(Record[Idx++]);
+  unsigned FieldCount = Record[Idx++];
+  const uint64_t *FieldOffsets = Record.data() + Idx;
+  Idx += FieldCount;
+
+  if (!Record[Idx++])
+    return new (Context) ASTRecordLayout(Context, Size, Alignment, DataSize,
+                                         FieldOffsets, FieldCount);
+
+  CharUnits NonVirtualSize = CharUnits::fromQuantity(Record[Idx++]);
+  CharUnits NonVirtualAlign = CharUnits::fromQuantity(Record[Idx++]);
+  CharUnits SizeOfLargestEmptySubobject
+    = CharUnits::fromQuantity(Record[Idx++]);
+  CharUnits VBPtrOffset = CharUnits::fromQuantity(Record[Idx++]);
+  CXXRecordDecl *PrimaryBase = GetLocalDeclAs<CXXRecordDecl>(F, Record[Idx++]);
+  bool IsPrimaryBaseVirtual = Record[Idx++];
+
+  ASTRecordLayout::BaseOffsetsMapTy BaseOffsets;
+  for (unsigned I = 0, N = Record[Idx++]; I != N; ++I) {
+    CXXRecordDecl *Base = GetLocalDeclAs<CXXRecordDecl>(F, Record[Idx++]);
+    BaseOffsets[Base] = CharUnits::fromQuantity(Record[Idx++]);
+  }
+
+  ASTRecordLayout::BaseOffsetsMapTy VBaseOffsets;
+  for (unsigned I = 0, N = Record[Idx++]; I != N; ++I) {
+    CXXRecordDecl *VBase = GetLocalDeclAs<CXXRecordDecl>(F, Record[Idx++]);
+    VBaseOffsets[VBase] = CharUnits::fromQuantity(Record[Idx++]);
+  }
+
+  return new (Context) ASTRecordLayout(Context, Size, Alignment, VBPtrOffset,
+                                       DataSize, FieldOffsets, FieldCount,
+                                       NonVirtualSize, NonVirtualAlign,
+                                       SizeOfLargestEmptySubobject,
+                                       PrimaryBase, IsPrimaryBaseVirtual,
+                                       BaseOffsets, VBaseOffsets);
+}
+
 serialization::DeclID 
 ASTReader::getGlobalDeclID(Module &F, unsigned LocalID) const {
   if (LocalID < NUM_PREDEF_DECL_IDS)
@@ -4287,6 +4403,9 @@ void ASTReader::PrintStats() {
     std::fprintf(stderr, "  %u/%u statements read (%f%%)\n",
                  NumStatementsRead, TotalNumStatements,
                  ((float)NumStatementsRead/TotalNumStatements * 100));
+  std::fprintf(stderr, "  %u implicit template instantiations read\n",
+               NumInstantiationsRead);
+  std::fprintf(stderr, "  %u record layouts read\n", NumRecordLayoutsRead);
   if (TotalNumMacros)
     std::fprintf(stderr, "  %u/%u macros read (%f%%)\n",
                  NumMacrosRead, TotalNumMacros,
@@ -5422,7 +5541,8 @@ ASTReader::ASTReader(Preprocessor &PP, ASTContext &Context,
     DisableValidation(DisableValidation),
     DisableStatCache(DisableStatCache), NumStatHits(0), NumStatMisses(0), 
     NumSLocEntriesRead(0), TotalNumSLocEntries(0), 
-    NumStatementsRead(0), TotalNumStatements(0), NumMacrosRead(0), 
+    NumStatementsRead(0), TotalNumStatements(0), NumInstantiationsRead(0),
+    NumRecordLayoutsRead(0), NumMacrosRead(0),
     TotalNumMacros(0), NumSelectorsRead(0), NumMethodPoolEntriesRead(0), 
     NumMethodPoolMisses(0), TotalNumMethodPoolEntries(0), 
     NumLexicalDeclContextsRead(0), TotalLexicalDeclContexts(0), 
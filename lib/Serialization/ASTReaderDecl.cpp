@@ -1420,6 +1420,16 @@ static bool isConsumerInterestedIn(Decl *D) {
   return false;
 }
 
+static bool isImplicitInstantiationDefinition(Decl *D) {
+  if (FunctionDecl *Func = dyn_cast<FunctionDecl>(D))
+    return Func->getTemplateSpecializationKind() == TSK_ImplicitInstantiation &&
+           Func->doesThisDeclarationHaveABody();
+  if (VarDecl *Var = dyn_cast<VarDecl>(D))
+    return Var->getTemplateSpecializationKind() == TSK_ImplicitInstantiation &&
+           Var->isThisDeclarationADefinition() == VarDecl::Definition;
+  return false;
+}
+
 /// \brief Get the correct cursor and offset for loading a declaration.
 ASTReader::RecordLocation
 ASTReader::DeclCursorForID(DeclID ID) {
@@ -1746,6 +1756,14 @@ Decl *ASTReader::ReadDeclRecord(DeclID ID) {
   
   if (ObjCChainedCategoriesInterfaces.count(ID))
     loadObjCChainedCategories(ID, cast<ObjCInterfaceDecl>(D));
+
+  // Remember where the stored layout of a record is, now that the record
+  // can be found by address.
+  RecordLayoutOffsetMap::iterator Layout = RecordLayoutOffsets.find(ID);
+  if (Layout != RecordLayoutOffsets.end()) {
+    PendingRecordLayouts[cast<RecordDecl>(D)] = Layout->second;
+    RecordLayoutOffsets.erase(Layout);
+  }
   
   // If we have deserialized a declaration that has a definition the
   // AST consumer might need to know about, queue it.
@@ -1753,6 +1771,11 @@ Decl *ASTReader::ReadDeclRecord(DeclID ID) {
   // loading, and some declarations may still be initializing.
   if (isConsumerInterestedIn(D))
       InterestingDecls.push_back(D);
+
+  // Instantiations performed by -fpch-instantiate-templates are only read
+  // when this translation unit refers to them.
+  if (isImplicitInstantiationDefinition(D))
+    ++NumInstantiationsRead;
   
   return D;
 }
@@ -22,6 +22,7 @@
 #include "clang/AST/DeclFriend.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/ExprCXX.h"
+#include "clang/AST/RecordLayout.h"
 #include "clang/AST/Type.h"
 #include "clang/AST/TypeLocVisitor.h"
 #include "clang/Serialization/ASTReader.h"
@@ -798,6 +799,7 @@ void ASTWriter::WriteBlockInfoBlock() {
   RECORD(KNOWN_NAMESPACES);
   RECORD(MODULE_OFFSET_MAP);
   RECORD(SOURCE_MANAGER_LINE_TABLE);
+  RECORD(RECORD_LAYOUTS);
   
   // SourceManager Block.
   BLOCK(SOURCE_MANAGER_BLOCK);
@@ -2995,6 +2997,10 @@ void ASTWriter::WriteASTCore(Sema &SemaRef, MemorizeStatCalls *StatCalls,
   AddTypeRef(Context.ObjCClassRedefinitionType, SpecialTypes);
   AddTypeRef(Context.ObjCSelRedefinitionType, SpecialTypes);
   
+  // Form the record of computed record layouts.
+  RecordData RecordLayouts;
+  AddRecordLayouts(Context, RecordLayouts);
+
   // Keep writing types and declarations until all types and
   // declarations have been written.
   Stream.EnterSubblock(DECLTYPES_BLOCK_ID, NUM_ALLOWED_ABBREVS_SIZE);
@@ -3028,6 +3034,9 @@ void ASTWriter::WriteASTCore(Sema &SemaRef, MemorizeStatCalls *StatCalls,
   
   Stream.EmitRecord(SPECIAL_TYPES, SpecialTypes);
 
+  if (!RecordLayouts.empty())
+    Stream.EmitRecord(RECORD_LAYOUTS, RecordLayouts);
+
   /// Build a record containing first declarations from a chained PCH and the
   /// most recent declarations in this AST that they point to.
   RecordData FirstLatestDeclIDs;
@@ -3214,6 +3223,78 @@ void ASTWriter::WriteChainedObjCCategories() {
   Stream.EmitRecord(OBJC_CHAINED_CATEGORIES, Record);
 }
 
+static void
+AddBaseOffsets(ASTWriter &Writer,
+               const llvm::DenseMap<const CXXRecordDecl *, CharUnits> &Map,
+               ASTWriter::RecordDataImpl &Record) {
+  // Sort by declaration ID so that the output does not depend on the order
+  // of the pointer-keyed map.
+  SmallVector<std::pair<serialization::DeclID, CharUnits>, 4> Offsets;
+  for (llvm::DenseMap<const CXXRecordDecl *, CharUnits>::const_iterator
+         I = Map.begin(), E = Map.end(); I != E; ++I)
+    Offsets.push_back(std::make_pair(Writer.GetDeclRef(I->first), I->second));
+  std::sort(Offsets.begin(), Offsets.end());
+
+  Record.push_back(Offsets.size());
+  for (unsigned I = 0, N = Offsets.size(); I != N; ++I) {
+    Record.push_back(Offsets[I].first);
+    Record.push_back(Offsets[I].second.getQuantity());
+  }
+}
+
+/// \brief Build the RECORD_LAYOUTS record from the layouts computed for
+/// records declared in this AST file.
+///
+/// Since the record refers to the laid out records and their bases by ID,
+/// it has to be built before the declarations are written.
+void ASTWriter::AddRecordLayouts(ASTContext &Context, RecordDataImpl &Record) {
+  SmallVector<std::pair<serialization::DeclID, const ASTRecordLayout *>, 64>
+    Layouts;
+  for (llvm::DenseMap<const RecordDecl*, const ASTRecordLayout*>::iterator
+         I = Context.ASTRecordLayouts.begin(),
+         E = Context.ASTRecordLayouts.end(); I != E; ++I) {
+    // Layouts of records loaded from another AST file belong to that file.
+    const RecordDecl *D = I->first;
+    if (!I->second || D->isFromASTFile() || D->isInvalidDecl())
+      continue;
+    Layouts.push_back(std::make_pair(GetDeclRef(D), I->second));
+  }
+  if (Layouts.empty())
+    return;
+  std::sort(Layouts.begin(), Layouts.end());
+
+  // The layouts are only meaningful for the target they were computed for.
+  // Record the properties they depend on, preceded by their number, so that
+  // the reader can ignore them rather than trust stale layouts.
+  Record.push_back(0);
+  AddRecordLayoutSignature(Context, Record);
+  Record[0] = Record.size() - 1;
+
+  for (unsigned I = 0, N = Layouts.size(); I != N; ++I) {
+    const ASTRecordLayout &Layout = *Layouts[I].second;
+    Record.push_back(Layouts[I].first);
+    Record.push_back(Layout.getSize().getQuantity());
+    Record.push_back(Layout.getAlignment().getQuantity());
+    Record.push_back(Layout.getDataSize().getQuantity());
+    Record.push_back(Layout.getFieldCount());
+    for (unsigned F = 0, FN = Layout.getFieldCount(); F != FN; ++F)
+      Record.push_back(Layout.getFieldOffset(F));
+
+    const ASTRecordLayout::CXXRecordLayoutInfo *CXXInfo = Layout.CXXInfo;
+    Record.push_back(CXXInfo != 0);
+    if (!CXXInfo)
+      continue;
+    Record.push_back(CXXInfo->NonVirtualSize.getQuantity());
+    Record.push_back(CXXInfo->NonVirtualAlign.getQuantity());
+    Record.push_back(CXXInfo->SizeOfLargestEmptySubobject.getQuantity());
+    Record.push_back(CXXInfo->VBPtrOffset.getQuantity());
+    AddDeclRef(CXXInfo->PrimaryBase.getPointer(), Record);
+    Record.push_back(CXXInfo->PrimaryBase.getInt());
+    AddBaseOffsets(*this, CXXInfo->BaseOffsets, Record);
+    AddBaseOffsets(*this, CXXInfo->VBaseOffsets, Record);
+  }
+}
+
 void ASTWriter::AddSourceLocation(SourceLocation Loc, RecordDataImpl &Record) {
   Record.push_back(Loc.getRawEncoding());
 }
@@ -184,6 +184,10 @@ CXXBaseSpecifier *
 ChainedIncludesSource::GetExternalCXXBaseSpecifiers(uint64_t Offset) {
   return getFinalReader().GetExternalCXXBaseSpecifiers(Offset);
 }
+const ASTRecordLayout *
+ChainedIncludesSource::GetExternalRecordLayout(const RecordDecl *D) {
+  return getFinalReader().GetExternalRecordLayout(D);
+}
 DeclContextLookupResult
 ChainedIncludesSource::FindExternalVisibleDeclsByName(const DeclContext *DC,
                                                       DeclarationName Name) {
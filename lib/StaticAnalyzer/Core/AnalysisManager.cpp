@@ -63,6 +63,7 @@ AnalysisManager::AnalysisManager(ASTContext &ctx, DiagnosticsEngine &diags,
     EagerlyTrimEGraph(ParentAM.EagerlyTrimEGraph)
 {
   AnaCtxMgr.getCFGBuildOptions().setAllAlwaysAdd();
+  AnaCtxMgr.setDenseLivenessLimit(ParentAM.AnaCtxMgr.getDenseLivenessLimit());
 }
 
 
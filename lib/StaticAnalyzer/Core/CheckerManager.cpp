@@ -17,6 +17,9 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/ObjCMessage.h"
 #include "clang/Analysis/ProgramPoint.h"
 #include "clang/AST/DeclBase.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 
 using namespace clang;
 using namespace ento;
@@ -48,6 +51,80 @@ void CheckerManager::finishedCheckerRegistration() {
 #endif
 }
 
+//===----------------------------------------------------------------------===//
+// Checker statistics.
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// Charges the time spent, and the exploded nodes created, while it is alive
+/// to a checker.  Declare it before any CheckerContext of the callback, so
+/// that the transitions the context generates on destruction are included.
+class CheckerCallbackStats {
+  CheckerManager &Mgr;
+  const CheckerBase *Checker;
+  const ExplodedGraph *G;
+  unsigned NodesBefore;
+  llvm::TimeRecord Start;
+
+public:
+  CheckerCallbackStats(CheckerManager &mgr, const CheckerBase *checker,
+                       const ExprEngine *Eng = 0)
+    : Mgr(mgr), Checker(checker), G(0), NodesBefore(0) {
+    if (!Mgr.hasCheckerStats())
+      return;
+    if (Eng) {
+      G = &Eng->getGraph();
+      NodesBefore = G->size();
+    }
+    Start = llvm::TimeRecord::getCurrentTime(/*Start=*/true);
+  }
+
+  ~CheckerCallbackStats() {
+    if (!Mgr.hasCheckerStats())
+      return;
+    llvm::TimeRecord Elapsed = llvm::TimeRecord::getCurrentTime(false);
+    Elapsed -= Start;
+    unsigned NodesAfter = G ? G->size() : 0;
+    Mgr.recordCheckerCallback(Checker, Elapsed,
+                              NodesAfter > NodesBefore ?
+                                NodesAfter - NodesBefore : 0);
+  }
+};
+}
+
+void CheckerManager::recordCheckerCallback(const CheckerBase *checker,
+                                           const llvm::TimeRecord &time,
+                                           unsigned numNodes) {
+  CheckerStats &S = CheckerStatsMap[checker];
+  S.Time += time;
+  ++S.NumCallbacks;
+  S.NumNodes += numNodes;
+}
+
+static bool isSlowerChecker(const CheckerManager::CheckerStats *LHS,
+                            const CheckerManager::CheckerStats *RHS) {
+  return LHS->Time.getWallTime() > RHS->Time.getWallTime();
+}
+
+void CheckerManager::printCheckerStats(raw_ostream &Out) const {
+  SmallVector<const CheckerStats *, 32> Ran;
+  for (llvm::DenseMap<const CheckerBase *, CheckerStats>::const_iterator
+         I = CheckerStatsMap.begin(), E = CheckerStatsMap.end(); I != E; ++I)
+    if (I->second.NumCallbacks)
+      Ran.push_back(&I->second);
+  std::stable_sort(Ran.begin(), Ran.end(), isSlowerChecker);
+
+  Out << "\n*** Checker Stats:\n";
+  Out << "   Wall Time    User Time    Callbacks        Nodes  Checker\n";
+  for (unsigned i = 0, e = Ran.size(); i != e; ++i) {
+    const CheckerStats &S = *Ran[i];
+    Out << llvm::format("  %10.4f   %10.4f  %11u  %11u  ",
+                        S.Time.getWallTime(), S.Time.getUserTime(),
+                        S.NumCallbacks, S.NumNodes)
+        << (S.Name.empty() ? "(unnamed)" : S.Name.c_str()) << '\n';
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // Functions for running checkers for AST traversing..
 //===----------------------------------------------------------------------===//
@@ -73,16 +150,20 @@ void CheckerManager::runCheckersOnASTDecl(const Decl *D, AnalysisManager& mgr,
 
   assert(checkers);
   for (CachedDeclCheckers::iterator
-         I = checkers->begin(), E = checkers->end(); I != E; ++I)
+         I = checkers->begin(), E = checkers->end(); I != E; ++I) {
+    CheckerCallbackStats Stats(*this, I->Checker);
     (*I)(D, mgr, BR);
+  }
 }
 
 void CheckerManager::runCheckersOnASTBody(const Decl *D, AnalysisManager& mgr,
                                           BugReporter &BR) {
   assert(D && D->hasBody());
 
-  for (unsigned i = 0, e = BodyCheckers.size(); i != e; ++i)
+  for (unsigned i = 0, e = BodyCheckers.size(); i != e; ++i) {
+    CheckerCallbackStats Stats(*this, BodyCheckers[i].Checker);
     BodyCheckers[i](D, mgr, BR);
+  }
 }
 
 //===----------------------------------------------------------------------===//
@@ -144,6 +225,8 @@ namespace {
                                            ProgramPoint::PostStmtKind;
       const ProgramPoint &L = ProgramPoint::getProgramPoint(S, K,
                                 Pred->getLocationContext(), checkFn.Checker);
+      CheckerCallbackStats Stats(Eng.getCheckerManager(), checkFn.Checker,
+                                 &Eng);
       CheckerContext C(Dst, Eng.getBuilder(), Eng, Pred, L, 0);
 
       checkFn(S, C);
@@ -183,6 +266,8 @@ namespace {
                                            ProgramPoint::PostStmtKind;
       const ProgramPoint &L = ProgramPoint::getProgramPoint(Msg.getOriginExpr(),
                                 K, Pred->getLocationContext(), checkFn.Checker);
+      CheckerCallbackStats Stats(Eng.getCheckerManager(), checkFn.Checker,
+                                 &Eng);
       CheckerContext C(Dst, Eng.getBuilder(), Eng, Pred, L, 0);
 
       checkFn(Msg, C);
@@ -225,6 +310,8 @@ namespace {
                                        ProgramPoint::PreStoreKind;
       const ProgramPoint &L = ProgramPoint::getProgramPoint(S, K,
                                 Pred->getLocationContext(), checkFn.Checker);
+      CheckerCallbackStats Stats(Eng.getCheckerManager(), checkFn.Checker,
+                                 &Eng);
       CheckerContext C(Dst, Eng.getBuilder(), Eng, Pred, L, 0);
 
       checkFn(Loc, IsLoad, S, C);
@@ -262,6 +349,8 @@ namespace {
       ProgramPoint::Kind K =  ProgramPoint::PreStmtKind;
       const ProgramPoint &L = ProgramPoint::getProgramPoint(S, K,
                                 Pred->getLocationContext(), checkFn.Checker);
+      CheckerCallbackStats Stats(Eng.getCheckerManager(), checkFn.Checker,
+                                 &Eng);
       CheckerContext C(Dst, Eng.getBuilder(), Eng, Pred, L, 0);
 
       checkFn(Loc, Val, S, C);
@@ -281,8 +370,10 @@ void CheckerManager::runCheckersForBind(ExplodedNodeSet &Dst,
 void CheckerManager::runCheckersForEndAnalysis(ExplodedGraph &G,
                                                BugReporter &BR,
                                                ExprEngine &Eng) {
-  for (unsigned i = 0, e = EndAnalysisCheckers.size(); i != e; ++i)
+  for (unsigned i = 0, e = EndAnalysisCheckers.size(); i != e; ++i) {
+    CheckerCallbackStats Stats(*this, EndAnalysisCheckers[i].Checker, &Eng);
     EndAnalysisCheckers[i](G, BR, Eng);
+  }
 }
 
 /// \brief Run checkers for end of path.
@@ -290,6 +381,7 @@ void CheckerManager::runCheckersForEndPath(EndOfFunctionNodeBuilder &B,
                                            ExprEngine &Eng) {
   for (unsigned i = 0, e = EndPathCheckers.size(); i != e; ++i) {
     CheckEndPathFunc fn = EndPathCheckers[i];
+    CheckerCallbackStats Stats(*this, fn.Checker, &Eng);
     EndOfFunctionNodeBuilder specialB = B.withCheckerTag(fn.Checker);
     fn(specialB, Eng);
   }
@@ -301,6 +393,7 @@ void CheckerManager::runCheckersForBranchCondition(const Stmt *condition,
                                                    ExprEngine &Eng) {
   for (unsigned i = 0, e = BranchConditionCheckers.size(); i != e; ++i) {
     CheckBranchConditionFunc fn = BranchConditionCheckers[i];
+    CheckerCallbackStats Stats(*this, fn.Checker, &Eng);
     fn(condition, B, Eng);
   }
 }
@@ -308,8 +401,10 @@ void CheckerManager::runCheckersForBranchCondition(const Stmt *condition,
 /// \brief Run checkers for live symbols.
 void CheckerManager::runCheckersForLiveSymbols(const ProgramState *state,
                                                SymbolReaper &SymReaper) {
-  for (unsigned i = 0, e = LiveSymbolsCheckers.size(); i != e; ++i)
+  for (unsigned i = 0, e = LiveSymbolsCheckers.size(); i != e; ++i) {
+    CheckerCallbackStats Stats(*this, LiveSymbolsCheckers[i].Checker);
     LiveSymbolsCheckers[i](state, SymReaper);
+  }
 }
 
 namespace {
@@ -332,6 +427,8 @@ namespace {
       ProgramPoint::Kind K = ProgramPoint::PostPurgeDeadSymbolsKind;
       const ProgramPoint &L = ProgramPoint::getProgramPoint(S, K,
                                 Pred->getLocationContext(), checkFn.Checker);
+      CheckerCallbackStats Stats(Eng.getCheckerManager(), checkFn.Checker,
+                                 &Eng);
       CheckerContext C(Dst, Eng.getBuilder(), Eng, Pred, L, 0);
 
       checkFn(SR, C);
@@ -369,6 +466,7 @@ CheckerManager::runCheckersForRegionChanges(const ProgramState *state,
     // bail out.
     if (!state)
       return NULL;
+    CheckerCallbackStats Stats(*this, RegionChangesCheckers[i].CheckFn.Checker);
     state = RegionChangesCheckers[i].CheckFn(state, invalidated, 
                                              ExplicitRegions, Regions);
   }
@@ -384,6 +482,7 @@ CheckerManager::runCheckersForEvalAssume(const ProgramState *state,
     // bail out.
     if (!state)
       return NULL;
+    CheckerCallbackStats Stats(*this, EvalAssumeCheckers[i].Checker);
     state = EvalAssumeCheckers[i](state, Cond, Assumption);
   }
   return state;
@@ -419,7 +518,11 @@ void CheckerManager::runCheckersForEvalCall(ExplodedNodeSet &Dst,
            EI = InlineCallCheckers.begin(), EE = InlineCallCheckers.end();
          EI != EE; ++EI) {
       ExplodedNodeSet checkDst;
-      bool evaluated = (*EI)(CE, Eng, Pred, checkDst);
+      bool evaluated;
+      {
+        CheckerCallbackStats Stats(*this, EI->Checker, &Eng);
+        evaluated = (*EI)(CE, Eng, Pred, checkDst);
+      }
       assert(!(evaluated && anyEvaluated)
              && "There are more than one checkers evaluating the call");
       if (evaluated) {
@@ -449,6 +552,7 @@ void CheckerManager::runCheckersForEvalCall(ExplodedNodeSet &Dst,
       { // CheckerContext generates transitions(populates checkDest) on
         // destruction, so introduce the scope to make sure it gets properly
         // populated.
+        CheckerCallbackStats Stats(*this, EI->Checker, &Eng);
         CheckerContext C(checkDst, Eng.getBuilder(), Eng, Pred, L, 0);
         evaluated = (*EI)(CE, C);
       }
@@ -478,8 +582,10 @@ void CheckerManager::runCheckersOnEndOfTranslationUnit(
                                                   const TranslationUnitDecl *TU,
                                                   AnalysisManager &mgr,
                                                   BugReporter &BR) {
-  for (unsigned i = 0, e = EndOfTranslationUnitCheckers.size(); i != e; ++i)
+  for (unsigned i = 0, e = EndOfTranslationUnitCheckers.size(); i != e; ++i) {
+    CheckerCallbackStats Stats(*this, EndOfTranslationUnitCheckers[i].Checker);
     EndOfTranslationUnitCheckers[i](TU, mgr, BR);
+  }
 }
 
 void CheckerManager::runCheckersForPrintState(raw_ostream &Out,
@@ -104,8 +104,10 @@ void CheckerRegistry::initializeManager(CheckerManager &checkerMgr,
   // Initialize the CheckerManager with all enabled checkers.
   for (CheckerInfoSet::iterator
          i = enabledCheckers.begin(), e = enabledCheckers.end(); i != e; ++i) {
+    checkerMgr.setCurrentCheckerName((*i)->FullName);
     (*i)->Initialize(checkerMgr);
   }
+  checkerMgr.setCurrentCheckerName(StringRef());
 }
 
 void CheckerRegistry::printHelp(llvm::raw_ostream &out,
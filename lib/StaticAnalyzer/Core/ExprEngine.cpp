@@ -62,6 +62,7 @@ ExprEngine::ExprEngine(AnalysisManager &mgr, bool gcEnabled)
     SymMgr(StateMgr.getSymbolManager()),
     svalBuilder(StateMgr.getSValBuilder()),
     EntryNode(NULL), currentStmt(NULL),
+    NumDeadBindingSweeps(0), NumDeadBindingSweepsSkipped(0),
     NSExceptionII(NULL), NSExceptionInstanceRaiseSelectors(NULL),
     RaiseSel(GetNullarySelector("raise", getContext())),
     ObjCGCEnabled(gcEnabled), BR(mgr, *this) {
@@ -215,6 +216,36 @@ void ExprEngine::processCFGElement(const CFGElement E,
   }
 }
 
+/// shouldRemoveDeadBindings - Returns true if the liveness of the bindings in
+///  the state could have changed since the last sweep, making it worth
+///  scanning the Environment and the Store for dead bindings before 'S'.
+static bool shouldRemoveDeadBindings(AnalysisManager &AMgr, const Stmt *S,
+                                     const ExplodedNode *Pred,
+                                     const LocationContext *LC) {
+  // Are we never purging state values?
+  if (AMgr.getPurgeMode() == PurgeNone)
+    return false;
+
+  // Is this the beginning of a basic block?  Variables and symbols can die
+  // along the edge that led here.
+  if (isa<BlockEntrance>(Pred->getLocation()))
+    return true;
+
+  // Is this on a non-expression?
+  const Expr *Ex = dyn_cast<Expr>(S);
+  if (!Ex)
+    return true;
+
+  // Clean up before a call, so that the callee starts from a clean state.
+  if (isa<CallExpr>(Ex))
+    return true;
+
+  // Is this an expression consumed by its parent?  Its value, and everything
+  // it refers to, stays live until the parent is evaluated, so postpone the
+  // sweep to the parent.
+  return !LC->getParentMap().isConsumedExpr(Ex);
+}
+
 void ExprEngine::ProcessStmt(const CFGStmt S, StmtNodeBuilder& builder) {
   // TODO: Use RAII to remove the unnecessary, tagged nodes.
   //RegisterCreatedNodes registerCreatedNodes(getGraph());
@@ -242,7 +273,9 @@ void ExprEngine::ProcessStmt(const CFGStmt S, StmtNodeBuilder& builder) {
   const LocationContext *LC = EntryNode->getLocationContext();
   SymbolReaper SymReaper(LC, currentStmt, SymMgr, getStoreManager());
 
-  if (AMgr.getPurgeMode() != PurgeNone) {
+  bool ShouldSweep = shouldRemoveDeadBindings(AMgr, currentStmt, EntryNode, LC);
+  if (ShouldSweep) {
+    ++NumDeadBindingSweeps;
     getCheckerManager().runCheckersForLiveSymbols(CleanedState, SymReaper);
 
     const StackFrameContext *SFC = LC->getCurrentStackFrame();
@@ -251,11 +284,18 @@ void ExprEngine::ProcessStmt(const CFGStmt S, StmtNodeBuilder& builder) {
     // and the store. TODO: The function should just return new env and store,
     // not a new state.
     CleanedState = StateMgr.removeDeadBindings(CleanedState, SFC, SymReaper);
+  } else if (AMgr.getPurgeMode() != PurgeNone) {
+    ++NumDeadBindingSweepsSkipped;
   }
 
   // Process any special transfer function for dead symbols.
   ExplodedNodeSet Tmp;
-  if (!SymReaper.hasDeadSymbols()) {
+  if (!ShouldSweep) {
+    // Nothing can have died since the last sweep, so there is no need for a
+    // cleaned node; visit the statement directly from the entry node.
+    Tmp.Add(EntryNode);
+
+  } else if (!SymReaper.hasDeadSymbols()) {
     // Generate a CleanedNode that has the environment and store cleaned
     // up. Since no symbols are dead, we can optimize and not clean out
     // the constraint manager.
@@ -325,6 +325,7 @@ void ProgramStateManager::recycleUnusedStates() {
     StateSet.RemoveNode(state);
     freeStates.push_back(state);
     state->~ProgramState();
+    ++NumStatesRecycled;
   }
   recentlyAllocatedStates.clear();
 }
@@ -332,6 +333,9 @@ void ProgramStateManager::recycleUnusedStates() {
 const ProgramState *ProgramStateManager::getPersistentStateWithGDM(
                                                      const ProgramState *FromState,
                                                      const ProgramState *GDMState) {
+  if (FromState->GDM == GDMState->GDM)
+    return FromState;
+
   ProgramState NewState = *FromState;
   NewState.GDM = GDMState->GDM;
   return getPersistentState(NewState);
@@ -343,8 +347,11 @@ const ProgramState *ProgramStateManager::getPersistentState(ProgramState &State)
   State.Profile(ID);
   void *InsertPos;
 
-  if (ProgramState *I = StateSet.FindNodeOrInsertPos(ID, InsertPos))
+  ++NumStateLookups;
+  if (ProgramState *I = StateSet.FindNodeOrInsertPos(ID, InsertPos)) {
+    ++NumStatesShared;
     return I;
+  }
 
   ProgramState *newState = 0;
   if (!freeStates.empty()) {
@@ -361,6 +368,10 @@ const ProgramState *ProgramStateManager::getPersistentState(ProgramState &State)
 }
 
 const ProgramState *ProgramState::makeWithStore(const StoreRef &store) const {
+  // Many bindings and invalidations leave the store as it was.
+  if (store.getStore() == getStore())
+    return this;
+
   ProgramState NewSt = *this;
   NewSt.setStore(store);
   return getStateManager().getPersistentState(NewSt);
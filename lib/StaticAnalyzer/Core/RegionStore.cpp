@@ -26,6 +26,7 @@
 #include "llvm/ADT/ImmutableList.h"
 #include "llvm/ADT/ImmutableMap.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace clang;
@@ -53,6 +54,12 @@ public:
   const MemRegion *getRegion() const { return P.getPointer(); }
   uint64_t getOffset() const { return Offset; }
 
+  /// getBaseRegion - Returns the base region of the key's region, which
+  ///  identifies the cluster the binding is stored in.
+  const MemRegion *getBaseRegion() const {
+    return getRegion()->getBaseRegion();
+  }
+
   void Profile(llvm::FoldingSetNodeID& ID) const {
     ID.AddPointer(P.getOpaqueValue());
     ID.AddInteger(Offset);
@@ -106,7 +113,12 @@ namespace llvm {
 // Actual Store type.
 //===----------------------------------------------------------------------===//
 
-typedef llvm::ImmutableMap<BindingKey, SVal> RegionBindings;
+// Bindings are clustered by the base region of their keys, so that lookups,
+// invalidation, and dead binding removal only touch the bindings of the
+// regions they care about.  Clusters are never empty; removing the last
+// binding of a cluster removes the cluster itself.
+typedef llvm::ImmutableMap<BindingKey, SVal> ClusterBindings;
+typedef llvm::ImmutableMap<const MemRegion *, ClusterBindings> RegionBindings;
 
 //===----------------------------------------------------------------------===//
 // Fine-grained control of RegionStoreManager.
@@ -194,12 +206,14 @@ RegionStoreSubRegionMap::process(SmallVectorImpl<const SubRegion*> &WL,
 class RegionStoreManager : public StoreManager {
   const RegionStoreFeatures Features;
   RegionBindings::Factory RBFactory;
+  ClusterBindings::Factory CBFactory;
 
 public:
   RegionStoreManager(ProgramStateManager& mgr, const RegionStoreFeatures &f)
     : StoreManager(mgr),
       Features(f),
-      RBFactory(mgr.getAllocator()) {}
+      RBFactory(mgr.getAllocator()),
+      CBFactory(mgr.getAllocator()) {}
 
   SubRegionMap *getSubRegionMap(Store store) {
     return getRegionStoreSubRegionMap(store);
@@ -264,6 +278,11 @@ public:   // Made public for helper classes.
                         BindingKey::Default);
   }
 
+  /// removeCluster - Removes all the bindings of the cluster of 'BaseR'.
+  RegionBindings removeCluster(RegionBindings B, const MemRegion *BaseR) {
+    return RBFactory.remove(B, BaseR);
+  }
+
 public: // Part of public interface to class.
 
   StoreRef Bind(Store store, Loc LV, SVal V);
@@ -399,13 +418,17 @@ public: // Part of public interface to class.
   void iterBindings(Store store, BindingsHandler& f) {
     RegionBindings B = GetRegionBindings(store);
     for (RegionBindings::iterator I=B.begin(), E=B.end(); I!=E; ++I) {
-      const BindingKey &K = I.getKey();
-      if (!K.isDirect())
-        continue;
-      if (const SubRegion *R = dyn_cast<SubRegion>(I.getKey().getRegion())) {
-        // FIXME: Possibly incorporate the offset?
-        if (!f.HandleBinding(*this, store, R, I.getData()))
-          return;
+      const ClusterBindings &Cluster = I.getData();
+      for (ClusterBindings::iterator CI = Cluster.begin(), CE = Cluster.end();
+           CI != CE; ++CI) {
+        const BindingKey &K = CI.getKey();
+        if (!K.isDirect())
+          continue;
+        if (const SubRegion *R = dyn_cast<SubRegion>(K.getRegion())) {
+          // FIXME: Possibly incorporate the offset?
+          if (!f.HandleBinding(*this, store, R, CI.getData()))
+            return;
+        }
       }
     }
   }
@@ -436,9 +459,13 @@ RegionStoreManager::getRegionStoreSubRegionMap(Store store) {
 
   SmallVector<const SubRegion*, 10> WL;
 
-  for (RegionBindings::iterator I=B.begin(), E=B.end(); I!=E; ++I)
-    if (const SubRegion *R = dyn_cast<SubRegion>(I.getKey().getRegion()))
-      M->process(WL, R);
+  for (RegionBindings::iterator I=B.begin(), E=B.end(); I!=E; ++I) {
+    const ClusterBindings &Cluster = I.getData();
+    for (ClusterBindings::iterator CI = Cluster.begin(), CE = Cluster.end();
+         CI != CE; ++CI)
+      if (const SubRegion *R = dyn_cast<SubRegion>(CI.getKey().getRegion()))
+        M->process(WL, R);
+  }
 
   // We also need to record in the subregion map "intermediate" regions that
   // don't have direct bindings but are super regions of those that do.
@@ -459,14 +486,9 @@ namespace {
 template <typename DERIVED>
 class ClusterAnalysis  {
 protected:
-  typedef BumpVector<BindingKey> RegionCluster;
-  typedef llvm::DenseMap<const MemRegion *, RegionCluster *> ClusterMap;
-  llvm::DenseMap<const RegionCluster*, unsigned> Visited;
-  typedef SmallVector<std::pair<const MemRegion *, RegionCluster*>, 10>
-    WorkList;
-
-  BumpVectorContext BVC;
-  ClusterMap ClusterM;
+  typedef SmallVector<const MemRegion *, 10> WorkList;
+
+  llvm::SmallPtrSet<const MemRegion *, 32> Visited;
   WorkList WL;
 
   RegionStoreManager &RM;
@@ -486,73 +508,42 @@ public:
 
   RegionBindings getRegionBindings() const { return B; }
 
-  RegionCluster &AddToCluster(BindingKey K) {
-    const MemRegion *R = K.getRegion();
-    const MemRegion *baseR = R->getBaseRegion();
-    RegionCluster &C = getCluster(baseR);
-    C.push_back(K, BVC);
-    static_cast<DERIVED*>(this)->VisitAddedToCluster(baseR, C);
-    return C;
-  }
-
   bool isVisited(const MemRegion *R) {
-    return (bool) Visited[&getCluster(R->getBaseRegion())];
-  }
-
-  RegionCluster& getCluster(const MemRegion *R) {
-    RegionCluster *&CRef = ClusterM[R];
-    if (!CRef) {
-      void *Mem = BVC.getAllocator().template Allocate<RegionCluster>();
-      CRef = new (Mem) RegionCluster(BVC, 10);
-    }
-    return *CRef;
+    return Visited.count(R->getBaseRegion());
   }
 
   void GenerateClusters() {
-      // Scan the entire set of bindings and make the region clusters.
+    // The bindings are already clustered by base region; visit each cluster
+    // once instead of each binding.
     for (RegionBindings::iterator RI = B.begin(), RE = B.end(); RI != RE; ++RI){
-      RegionCluster &C = AddToCluster(RI.getKey());
-      if (const MemRegion *R = RI.getData().getAsRegion()) {
-        // Generate a cluster, but don't add the region to the cluster
-        // if there aren't any bindings.
-        getCluster(R->getBaseRegion());
-      }
-      if (includeGlobals) {
-        const MemRegion *R = RI.getKey().getRegion();
-        if (isa<NonStaticGlobalSpaceRegion>(R->getMemorySpace()))
-          AddToWorkList(R, C);
-      }
+      const MemRegion *baseR = RI.getKey();
+      assert(!RI.getData().isEmpty() && "Empty clusters should be removed");
+      static_cast<DERIVED*>(this)->VisitAddedToCluster(baseR);
+      if (includeGlobals &&
+          isa<NonStaticGlobalSpaceRegion>(baseR->getMemorySpace()))
+        AddToWorkList(baseR);
     }
   }
 
-  bool AddToWorkList(const MemRegion *R, RegionCluster &C) {
-    if (unsigned &visited = Visited[&C])
+  bool AddToWorkList(const MemRegion *R) {
+    const MemRegion *baseR = R->getBaseRegion();
+    if (!Visited.insert(baseR))
       return false;
-    else
-      visited = 1;
 
-    WL.push_back(std::make_pair(R, &C));
+    WL.push_back(baseR);
     return true;
   }
 
-  bool AddToWorkList(BindingKey K) {
-    return AddToWorkList(K.getRegion());
-  }
-
-  bool AddToWorkList(const MemRegion *R) {
-    const MemRegion *baseR = R->getBaseRegion();
-    return AddToWorkList(baseR, getCluster(baseR));
-  }
-
   void RunWorkList() {
     while (!WL.empty()) {
-      const MemRegion *baseR;
-      RegionCluster *C;
-      llvm::tie(baseR, C) = WL.back();
-      WL.pop_back();
+      const MemRegion *baseR = WL.pop_back_val();
 
-        // First visit the cluster.
-      static_cast<DERIVED*>(this)->VisitCluster(baseR, C->begin(), C->end());
+        // First visit the cluster.  Each cluster is visited only once, so
+        // the current bindings still hold it unchanged.
+      if (const ClusterBindings *C = B.lookup(baseR)) {
+        ClusterBindings Cluster = *C;
+        static_cast<DERIVED*>(this)->VisitCluster(baseR, Cluster);
+      }
 
         // Next, visit the base region.
       static_cast<DERIVED*>(this)->VisitBaseRegion(baseR);
@@ -560,8 +551,8 @@ public:
   }
 
 public:
-  void VisitAddedToCluster(const MemRegion *baseR, RegionCluster &C) {}
-  void VisitCluster(const MemRegion *baseR, BindingKey *I, BindingKey *E) {}
+  void VisitAddedToCluster(const MemRegion *baseR) {}
+  void VisitCluster(const MemRegion *baseR, const ClusterBindings &C) {}
   void VisitBaseRegion(const MemRegion *baseR) {}
 };
 }
@@ -600,7 +591,7 @@ public:
     : ClusterAnalysis<invalidateRegionsWorker>(rm, stateMgr, b, includeGlobals),
       Ex(ex), Count(count), IS(is), Regions(r) {}
 
-  void VisitCluster(const MemRegion *baseR, BindingKey *I, BindingKey *E);
+  void VisitCluster(const MemRegion *baseR, const ClusterBindings &C);
   void VisitBaseRegion(const MemRegion *baseR);
 
 private:
@@ -625,10 +616,15 @@ void invalidateRegionsWorker::VisitBinding(SVal V) {
     const MemRegion *LazyR = LCS->getRegion();
     RegionBindings B = RegionStoreManager::GetRegionBindings(LCS->getStore());
 
-    for (RegionBindings::iterator RI = B.begin(), RE = B.end(); RI != RE; ++RI){
-      const SubRegion *baseR = dyn_cast<SubRegion>(RI.getKey().getRegion());
+    // Only the cluster of the lazy region can hold its subregions.
+    const ClusterBindings *C = B.lookup(LazyR->getBaseRegion());
+    if (!C)
+      return;
+
+    for (ClusterBindings::iterator I = C->begin(), E = C->end(); I != E; ++I) {
+      const SubRegion *baseR = dyn_cast<SubRegion>(I.getKey().getRegion());
       if (baseR && baseR->isSubRegionOf(LazyR))
-        VisitBinding(RI.getData());
+        VisitBinding(I.getData());
     }
 
     return;
@@ -636,15 +632,13 @@ void invalidateRegionsWorker::VisitBinding(SVal V) {
 }
 
 void invalidateRegionsWorker::VisitCluster(const MemRegion *baseR,
-                                           BindingKey *I, BindingKey *E) {
-  for ( ; I != E; ++I) {
-    // Get the old binding.  Is it a region?  If so, add it to the worklist.
-    const BindingKey &K = *I;
-    if (const SVal *V = RM.lookup(B, K))
-      VisitBinding(*V);
+                                           const ClusterBindings &C) {
+  // Get the old bindings.  Are they regions?  If so, add them to the
+  // worklist.
+  for (ClusterBindings::iterator I = C.begin(), E = C.end(); I != E; ++I)
+    VisitBinding(I.getData());
 
-    B = RM.removeBinding(B, K);
-  }
+  B = RM.removeCluster(B, baseR);
 }
 
 void invalidateRegionsWorker::VisitBaseRegion(const MemRegion *baseR) {
@@ -1294,13 +1288,17 @@ bool RegionStoreManager::includedInBindings(Store store,
   region = region->getBaseRegion();
   
   for (RegionBindings::iterator it = B.begin(), ei = B.end(); it != ei; ++it) {
-    const BindingKey &K = it.getKey();
-    if (region == K.getRegion())
-      return true;
-    const SVal &D = it.getData();
-    if (const MemRegion *r = D.getAsRegion())
-      if (r == region)
+    const ClusterBindings &Cluster = it.getData();
+    for (ClusterBindings::iterator ci = Cluster.begin(), ce = Cluster.end();
+         ci != ce; ++ci) {
+      const BindingKey &K = ci.getKey();
+      if (region == K.getRegion())
         return true;
+      const SVal &D = ci.getData();
+      if (const MemRegion *r = D.getAsRegion())
+        if (r == region)
+          return true;
+    }
   }
   return false;
 }
@@ -1595,7 +1593,12 @@ RegionBindings RegionStoreManager::addBinding(RegionBindings B, BindingKey K,
                                               SVal V) {
   if (!K.isValid())
     return B;
-  return RBFactory.add(B, K, V);
+
+  const MemRegion *Base = K.getBaseRegion();
+  const ClusterBindings *ExistingCluster = B.lookup(Base);
+  ClusterBindings Cluster = (ExistingCluster ? *ExistingCluster
+                                             : CBFactory.getEmptyMap());
+  return RBFactory.add(B, Base, CBFactory.add(Cluster, K, V));
 }
 
 RegionBindings RegionStoreManager::addBinding(RegionBindings B,
@@ -1607,7 +1610,11 @@ RegionBindings RegionStoreManager::addBinding(RegionBindings B,
 const SVal *RegionStoreManager::lookup(RegionBindings B, BindingKey K) {
   if (!K.isValid())
     return NULL;
-  return B.lookup(K);
+
+  const ClusterBindings *Cluster = B.lookup(K.getBaseRegion());
+  if (!Cluster)
+    return NULL;
+  return Cluster->lookup(K);
 }
 
 const SVal *RegionStoreManager::lookup(RegionBindings B,
@@ -1620,7 +1627,16 @@ RegionBindings RegionStoreManager::removeBinding(RegionBindings B,
                                                  BindingKey K) {
   if (!K.isValid())
     return B;
-  return RBFactory.remove(B, K);
+
+  const MemRegion *Base = K.getBaseRegion();
+  const ClusterBindings *Cluster = B.lookup(Base);
+  if (!Cluster)
+    return B;
+
+  ClusterBindings NewCluster = CBFactory.remove(*Cluster, K);
+  if (NewCluster.isEmpty())
+    return RBFactory.remove(B, Base);
+  return RBFactory.add(B, Base, NewCluster);
 }
 
 RegionBindings RegionStoreManager::removeBinding(RegionBindings B,
@@ -1649,8 +1665,8 @@ public:
       SymReaper(symReaper), CurrentLCtx(LCtx) {}
 
   // Called by ClusterAnalysis.
-  void VisitAddedToCluster(const MemRegion *baseR, RegionCluster &C);
-  void VisitCluster(const MemRegion *baseR, BindingKey *I, BindingKey *E);
+  void VisitAddedToCluster(const MemRegion *baseR);
+  void VisitCluster(const MemRegion *baseR, const ClusterBindings &C);
 
   void VisitBindingKey(BindingKey K);
   bool UpdatePostponed();
@@ -1658,19 +1674,18 @@ public:
 };
 }
 
-void removeDeadBindingsWorker::VisitAddedToCluster(const MemRegion *baseR,
-                                                   RegionCluster &C) {
+void removeDeadBindingsWorker::VisitAddedToCluster(const MemRegion *baseR) {
 
   if (const VarRegion *VR = dyn_cast<VarRegion>(baseR)) {
     if (SymReaper.isLive(VR))
-      AddToWorkList(baseR, C);
+      AddToWorkList(baseR);
 
     return;
   }
 
   if (const SymbolicRegion *SR = dyn_cast<SymbolicRegion>(baseR)) {
     if (SymReaper.isLive(SR->getSymbol()))
-      AddToWorkList(SR, C);
+      AddToWorkList(SR);
     else
       Postponed.push_back(SR);
 
@@ -1678,7 +1693,7 @@ void removeDeadBindingsWorker::VisitAddedToCluster(const MemRegion *baseR,
   }
 
   if (isa<NonStaticGlobalSpaceRegion>(baseR)) {
-    AddToWorkList(baseR, C);
+    AddToWorkList(baseR);
     return;
   }
 
@@ -1688,14 +1703,14 @@ void removeDeadBindingsWorker::VisitAddedToCluster(const MemRegion *baseR,
       cast<StackArgumentsSpaceRegion>(TR->getSuperRegion());
     const StackFrameContext *RegCtx = StackReg->getStackFrame();
     if (RegCtx == CurrentLCtx || RegCtx->isParentOf(CurrentLCtx))
-      AddToWorkList(TR, C);
+      AddToWorkList(TR);
   }
 }
 
 void removeDeadBindingsWorker::VisitCluster(const MemRegion *baseR,
-                                            BindingKey *I, BindingKey *E) {
-  for ( ; I != E; ++I)
-    VisitBindingKey(*I);
+                                            const ClusterBindings &C) {
+  for (ClusterBindings::iterator I = C.begin(), E = C.end(); I != E; ++I)
+    VisitBindingKey(I.getKey());
 }
 
 void removeDeadBindingsWorker::VisitBinding(SVal V) {
@@ -1705,10 +1720,16 @@ void removeDeadBindingsWorker::VisitBinding(SVal V) {
 
     const MemRegion *LazyR = LCS->getRegion();
     RegionBindings B = RegionStoreManager::GetRegionBindings(LCS->getStore());
-    for (RegionBindings::iterator RI = B.begin(), RE = B.end(); RI != RE; ++RI){
-      const SubRegion *baseR = dyn_cast<SubRegion>(RI.getKey().getRegion());
+
+    // Only the cluster of the lazy region can hold its subregions.
+    const ClusterBindings *C = B.lookup(LazyR->getBaseRegion());
+    if (!C)
+      return;
+
+    for (ClusterBindings::iterator I = C->begin(), E = C->end(); I != E; ++I) {
+      const SubRegion *baseR = dyn_cast<SubRegion>(I.getKey().getRegion());
       if (baseR && baseR->isSubRegionOf(LazyR))
-        VisitBinding(RI.getData());
+        VisitBinding(I.getData());
     }
     return;
   }
@@ -1793,23 +1814,28 @@ StoreRef RegionStoreManager::removeDeadBindings(Store store,
   // as live.  We now remove all the regions that are dead from the store
   // as well as update DSymbols with the set symbols that are now dead.
   for (RegionBindings::iterator I = B.begin(), E = B.end(); I != E; ++I) {
-    const BindingKey &K = I.getKey();
+    const MemRegion *BaseR = I.getKey();
 
     // If the cluster has been visited, we know the region has been marked.
-    if (W.isVisited(K.getRegion()))
+    if (W.isVisited(BaseR))
       continue;
 
-    // Remove the dead entry.
-    B = removeBinding(B, K);
-
-    // Mark all non-live symbols that this binding references as dead.
-    if (const SymbolicRegion* SymR = dyn_cast<SymbolicRegion>(K.getRegion()))
-      SymReaper.maybeDead(SymR->getSymbol());
-
-    SVal X = I.getData();
-    SVal::symbol_iterator SI = X.symbol_begin(), SE = X.symbol_end();
-    for (; SI != SE; ++SI)
-      SymReaper.maybeDead(*SI);
+    // Remove the dead cluster.
+    B = removeCluster(B, BaseR);
+
+    // Mark all non-live symbols that this cluster references as dead.
+    const ClusterBindings &Cluster = I.getData();
+    for (ClusterBindings::iterator CI = Cluster.begin(), CE = Cluster.end();
+         CI != CE; ++CI) {
+      const MemRegion *R = CI.getKey().getRegion();
+      if (const SymbolicRegion *SymR = dyn_cast<SymbolicRegion>(R))
+        SymReaper.maybeDead(SymR->getSymbol());
+
+      SVal X = CI.getData();
+      SVal::symbol_iterator SI = X.symbol_begin(), SE = X.symbol_end();
+      for (; SI != SE; ++SI)
+        SymReaper.maybeDead(*SI);
+    }
   }
 
   return StoreRef(B.getRootWithoutRetain(), *this);
@@ -1860,6 +1886,10 @@ void RegionStoreManager::print(Store store, raw_ostream &OS,
   RegionBindings B = GetRegionBindings(store);
   OS << "Store (direct and default bindings):" << nl;
 
-  for (RegionBindings::iterator I = B.begin(), E = B.end(); I != E; ++I)
-    OS << ' ' << I.getKey() << " : " << I.getData() << nl;
+  for (RegionBindings::iterator I = B.begin(), E = B.end(); I != E; ++I) {
+    const ClusterBindings &Cluster = I.getData();
+    for (ClusterBindings::iterator CI = Cluster.begin(), CE = Cluster.end();
+         CI != CE; ++CI)
+      OS << ' ' << CI.getKey() << " : " << CI.getData() << nl;
+  }
 }
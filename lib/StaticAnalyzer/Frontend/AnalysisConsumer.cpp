@@ -31,6 +31,8 @@
 #include "clang/Basic/SourceManager.h"
 #include "clang/Frontend/AnalyzerOptions.h"
 #include "clang/Lex/Preprocessor.h"
+#include "clang/Sema/Sema.h"
+#include "clang/Sema/SemaConsumer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
@@ -59,9 +61,10 @@ createPlistHTMLDiagnosticConsumer(const std::string& prefix,
 
 namespace {
 
-class AnalysisConsumer : public ASTConsumer {
+class AnalysisConsumer : public SemaConsumer {
 public:
   ASTContext *Ctx;
+  Sema *S;
   const Preprocessor &PP;
   const std::string OutDir;
   AnalyzerOptions Opts;
@@ -76,11 +79,25 @@ public:
   llvm::OwningPtr<CheckerManager> checkerMgr;
   llvm::OwningPtr<AnalysisManager> Mgr;
 
+  /// Statistics.
+  unsigned NumSharedContexts;
+  unsigned NumSharedContextsReused;
+  unsigned NumExplodedNodes;
+  unsigned NumStateLookups;
+  unsigned NumStatesShared;
+  unsigned NumStatesRecycled;
+  unsigned NumDeadBindingSweeps;
+  unsigned NumDeadBindingSweepsSkipped;
+
   AnalysisConsumer(const Preprocessor& pp,
                    const std::string& outdir,
                    const AnalyzerOptions& opts,
                    ArrayRef<std::string> plugins)
-    : Ctx(0), PP(pp), OutDir(outdir), Opts(opts), Plugins(plugins), PD(0) {
+    : Ctx(0), S(0), PP(pp), OutDir(outdir), Opts(opts), Plugins(plugins),
+      PD(0), NumSharedContexts(0), NumSharedContextsReused(0),
+      NumExplodedNodes(0), NumStateLookups(0), NumStatesShared(0),
+      NumStatesRecycled(0), NumDeadBindingSweeps(0),
+      NumDeadBindingSweepsSkipped(0) {
     DigestAnalyzerOptions();
   }
 
@@ -157,8 +174,37 @@ public:
                                   Opts.UnoptimizedCFG, Opts.CFGAddImplicitDtors,
                                   Opts.CFGAddInitializers,
                                   Opts.EagerlyTrimEGraph));
+
+    AnalysisContextManager &ACM = Mgr->getAnalysisContextManager();
+    switch (Opts.AnalysisLivenessOpt) {
+    default:
+      break;
+    case LivenessSparse:
+      ACM.setDenseLivenessLimit(0);
+      break;
+    case LivenessDense:
+      ACM.setDenseLivenessLimit(~0U);
+      break;
+    }
+  }
+
+  virtual void InitializeSema(Sema &SemaRef) {
+    // Let Sema's analysis-based warnings build the CFGs of the code we are
+    // going to analyze, so that we can reuse them.
+    S = &SemaRef;
+    AnalysisContextManager &ACM = Mgr->getAnalysisContextManager();
+    ACM.setShareMainFileOnly(!Opts.AnalyzeAll);
+    S->AnalysisWarnings.setSharedContexts(&ACM);
   }
 
+  virtual void ForgetSema() {
+    if (S)
+      S->AnalysisWarnings.setSharedContexts(0);
+    S = 0;
+  }
+
+  virtual void PrintStats();
+
   virtual void HandleTranslationUnit(ASTContext &C);
   void HandleDeclContext(ASTContext &C, DeclContext *dc);
   void HandleDeclContextDecl(ASTContext &C, Decl *D);
@@ -244,6 +290,15 @@ void AnalysisConsumer::HandleTranslationUnit(ASTContext &C) {
   // After all decls handled, run checkers on the entire TranslationUnit.
   checkerMgr->runCheckersOnEndOfTranslationUnit(TU, *Mgr, BR);
 
+  if (Opts.CheckerStats)
+    checkerMgr->printCheckerStats(llvm::errs());
+
+  // Stop sharing contexts with Sema before they go away.
+  ForgetSema();
+  AnalysisContextManager &ACM = Mgr->getAnalysisContextManager();
+  NumSharedContexts = ACM.getNumSharedContexts();
+  NumSharedContextsReused = ACM.getNumSharedContextsReused();
+
   // Explicitly destroy the PathDiagnosticConsumer.  This will flush its output.
   // FIXME: This should be replaced with something that doesn't rely on
   // side-effects in PathDiagnosticConsumer's destructor. This is required when
@@ -251,6 +306,20 @@ void AnalysisConsumer::HandleTranslationUnit(ASTContext &C) {
   Mgr.reset(NULL);
 }
 
+void AnalysisConsumer::PrintStats() {
+  llvm::errs() << "\n*** Analysis Consumer Stats:\n";
+  llvm::errs() << "  " << NumSharedContexts
+               << " analysis contexts shared with Sema.\n"
+               << "  " << NumSharedContextsReused
+               << " CFGs reused instead of rebuilt.\n";
+  llvm::errs() << "  " << NumExplodedNodes << " exploded nodes.\n"
+               << "  " << NumStateLookups << " program state lookups, "
+               << NumStatesShared << " of them shared.\n"
+               << "  " << NumStatesRecycled << " program states recycled.\n"
+               << "  " << NumDeadBindingSweeps << " dead binding sweeps, "
+               << NumDeadBindingSweepsSkipped << " postponed.\n";
+}
+
 static void FindBlocks(DeclContext *D, SmallVectorImpl<Decl*> &WL) {
   if (BlockDecl *BD = dyn_cast<BlockDecl>(D))
     WL.push_back(BD);
@@ -320,6 +389,14 @@ static void ActionExprEngine(AnalysisConsumer &C, AnalysisManager &mgr,
   // Execute the worklist algorithm.
   Eng.ExecuteWorkList(mgr.getStackFrame(D, 0), mgr.getMaxNodes());
 
+  C.NumExplodedNodes += Eng.getGraph().size();
+  ProgramStateManager &StateMgr = Eng.getStateManager();
+  C.NumStateLookups += StateMgr.getNumStateLookups();
+  C.NumStatesShared += StateMgr.getNumStatesShared();
+  C.NumStatesRecycled += StateMgr.getNumStatesRecycled();
+  C.NumDeadBindingSweeps += Eng.getNumDeadBindingSweeps();
+  C.NumDeadBindingSweepsSkipped += Eng.getNumDeadBindingSweepsSkipped();
+
   // Release the auditor (if any) so that it doesn't monitor the graph
   // created BugReporter.
   ExplodedNode::SetAuditor(0);
@@ -0,0 +1,24 @@
+// RUN: %clang_cc1 -analyze -analyzer-checker=core,experimental.unix.Malloc \
+// RUN:   -analyzer-store=region -analyzer-checker-stats %s > %t 2>&1
+// RUN: FileCheck -check-prefix=MALLOC %s < %t
+// RUN: FileCheck -check-prefix=DEREF %s < %t
+
+typedef __typeof(sizeof(int)) size_t;
+void *malloc(size_t);
+void free(void *);
+
+int f(int *p) {
+  int *q = malloc(sizeof(int));
+  if (!q)
+    return 0;
+  *q = *p;
+  free(q);
+  return 1;
+}
+
+// MALLOC: *** Checker Stats:
+// MALLOC-NEXT: Wall Time User Time Callbacks Nodes Checker
+// MALLOC: {{[0-9.]+ +[0-9.]+ +[1-9][0-9]* +[0-9]+}} experimental.unix.Malloc
+
+// DEREF: *** Checker Stats:
+// DEREF: {{[0-9.]+ +[0-9.]+ +[1-9][0-9]* +[0-9]+}} core.NullDereference
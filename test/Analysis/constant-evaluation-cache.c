@@ -0,0 +1,16 @@
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -fconstant-evaluation-cache -print-stats %s 2>&1 | FileCheck %s
+
+// The case values are folded when the CFG is built and again on each path
+// through the switch.
+int f(int x) {
+  switch (x) {
+  case 1 + 2:
+    return 1;
+  case 4 * 5:
+    return 2;
+  default:
+    return 0;
+  }
+}
+
+// CHECK: constant foldings cached, reused {{[1-9][0-9]*}} times
@@ -0,0 +1,23 @@
+// RUN: %clang_cc1 -analyze -analyzer-checker=core,experimental.unix.Malloc \
+// RUN:   -analyzer-store=region -verify -print-stats %s 2>&1 | FileCheck %s
+
+typedef __typeof(sizeof(int)) size_t;
+void *malloc(size_t);
+
+// Subexpressions consumed by their parents do not trigger a sweep of dead
+// bindings; the sweep runs once the enclosing expression is evaluated.
+int f(int a, int b, int c) {
+  int x = (a + b) * (b - c) + (a * c);
+  return x;
+}
+
+// Postponing the sweep does not lose the leak.
+void g(int n) {
+  int *p = malloc(sizeof(int) * (n + 1));
+  if (p)
+    *p = n;
+  return; // expected-warning{{Allocated memory never released. Potential memory leak.}}
+}
+
+// CHECK: *** Analysis Consumer Stats:
+// CHECK: {{[1-9][0-9]*}} dead binding sweeps, {{[1-9][0-9]*}} postponed.
@@ -0,0 +1,22 @@
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -Wuninitialized -print-stats \
+// RUN:   %s 2>&1 | FileCheck %s
+
+// The CFGs built for Sema's analysis-based warnings are reused by the
+// analyzer instead of being built again.
+int f(int x) {
+  int y = x;
+  if (y)
+    return 1;
+  return y;
+}
+
+int g(int *p) {
+  if (*p)
+    return 1;
+  else
+    return 0;
+}
+
+// CHECK: *** Analysis Consumer Stats:
+// CHECK-NEXT: 2 analysis contexts shared with Sema.
+// CHECK-NEXT: 2 CFGs reused instead of rebuilt.
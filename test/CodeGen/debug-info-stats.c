@@ -0,0 +1,11 @@
+// RUN: %clang_cc1 -emit-llvm-only -g -print-stats %s 2>&1 | FileCheck %s
+
+struct Defined { int x; int y; };
+struct Declared;
+
+struct Defined d;
+struct Declared *p;
+
+// CHECK: *** Debug Info Stats:
+// CHECK: 1 record types described with their definition (2 elements).
+// CHECK: 1 record types described as declarations only.
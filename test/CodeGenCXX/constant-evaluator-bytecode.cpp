@@ -0,0 +1,23 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -emit-llvm-only \
+// RUN:   -fconstant-evaluator=bytecode -print-stats %s 2>&1 | FileCheck %s
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -emit-llvm-only \
+// RUN:   -fconstant-evaluator=check %s
+
+// Array bounds are evaluated while Sema still builds the expressions, so
+// their programs are not kept.
+const int N = (4 * 3 + 1) << 2;
+int a[N];
+int b[N == 52 ? 1 : -1];
+
+// The immediate operands are evaluated again by CodeGen once the function
+// is finished; the program of the initializer of Shift is compiled once and
+// reused for the second call.
+typedef char V16c __attribute__((vector_size(16)));
+const int Shift = (1 << 2) + 4;
+
+V16c align(V16c x, V16c y) {
+  V16c r = __builtin_ia32_palignr128(x, y, Shift);
+  return __builtin_ia32_palignr128(r, y, Shift);
+}
+
+// CHECK: integer constant programs cached, reused {{[1-9][0-9]*}} times
@@ -0,0 +1,33 @@
+// RUN: %clang_cc1 -triple x86_64-apple-darwin10 -emit-llvm -g -flimit-debug-info %s -o %t
+// RUN: FileCheck -check-prefix=CHECK-B %s < %t
+// RUN: FileCheck -check-prefix=CHECK-C %s < %t
+// RUN: FileCheck -check-prefix=ELSEWHERE %s < %t
+// RUN: %clang_cc1 -triple x86_64-apple-darwin10 -emit-llvm -g %s -o - | FileCheck -check-prefix=FULL %s
+
+// The key function of A is defined in another translation unit, which emits
+// the vtable and describes A in full.
+struct A {
+  virtual void f();
+  int a_member;
+};
+A a;
+
+// The key function of B is defined here, so B is described here even though
+// nothing refers to it before its key function is defined.
+struct B {
+  virtual void g();
+  int b_member;
+};
+B b;
+void B::g() {}
+
+// Classes without a vtable are described wherever they are used.
+struct C {
+  int c_member;
+};
+C c;
+
+// CHECK-B: metadata !"b_member"
+// CHECK-C: metadata !"c_member"
+// ELSEWHERE-NOT: metadata !"a_member"
+// FULL: metadata !"a_member"
@@ -0,0 +1,28 @@
+// RUN: %clang_cc1 -emit-llvm -triple x86_64-apple-darwin10 -o - %s | FileCheck %s
+
+// Prefixes are mangled once and then replayed, substitutions included, for
+// later names sharing them.
+namespace A {
+  namespace B {
+    struct X {};
+    struct C {
+      void f(C *);
+      void g(X, C);
+      struct D {
+        void h(D *, C *);
+      };
+    };
+    template<typename T> struct T1 {
+      void m(T1 *) {}
+    };
+  }
+}
+
+// CHECK: define void @_ZN1A1B1C1fEPS1_(
+void A::B::C::f(C *) {}
+// CHECK: define void @_ZN1A1B1C1gENS0_1XES1_(
+void A::B::C::g(X, C) {}
+// CHECK: define void @_ZN1A1B1C1D1hEPS2_PS1_(
+void A::B::C::D::h(D *, C *) {}
+// CHECK: define weak_odr void @_ZN1A1B2T1INS0_1XEE1mEPS3_(
+template struct A::B::T1<A::B::X>;
@@ -0,0 +1,24 @@
+// Annotate ranges of a PCH header that start between two of its
+// preprocessed entities; the first entity in the range must still be found.
+
+int use = sizeof(a1) + sizeof(b7);
+
+// RUN: c-index-test -write-pch %t.h.pch %s.h -Xclang -detailed-preprocessing-record
+// RUN: c-index-test -test-annotate-tokens=%s.h:3:1:4:11 -include %t.h %s \
+// RUN:   | FileCheck -check-prefix=START %s
+// RUN: c-index-test -test-annotate-tokens=%s.h:7:1:8:11 -include %t.h %s \
+// RUN:   | FileCheck -check-prefix=MIDDLE %s
+// RUN: c-index-test -test-annotate-tokens=%s.h:15:1:16:11 -include %t.h %s \
+// RUN:   | FileCheck -check-prefix=END %s
+
+// START: Keyword: "int" [3:1 - 3:4]
+// START: Identifier: "M" [4:1 - 4:2] macro expansion=M:1:9
+// START: Identifier: "a2" [4:8 - 4:10]
+
+// MIDDLE: Keyword: "int" [7:1 - 7:4]
+// MIDDLE: Identifier: "M" [8:1 - 8:2] macro expansion=M:1:9
+// MIDDLE: Identifier: "a4" [8:8 - 8:10]
+
+// END: Keyword: "int" [15:1 - 15:4]
+// END: Identifier: "M" [16:1 - 16:2] macro expansion=M:1:9
+// END: Identifier: "a8" [16:8 - 16:10]
@@ -0,0 +1,16 @@
+#define M(x) x
+M(int) a1;
+int b1;
+M(int) a2;
+int b2;
+M(int) a3;
+int b3;
+M(int) a4;
+int b4;
+M(int) a5;
+int b5;
+M(int) a6;
+int b6;
+M(int) a7;
+int b7;
+M(int) a8;
@@ -0,0 +1,22 @@
+// Test this without pch.
+// RUN: %clang_cc1 -triple x86_64-apple-darwin10 -include %S/cxx-record-layout.h -fsyntax-only -verify %s
+
+// Test with pch, whose record layouts are stored rather than recomputed.
+// RUN: %clang_cc1 -triple x86_64-apple-darwin10 -x c++-header -emit-pch -o %t %S/cxx-record-layout.h
+// RUN: %clang_cc1 -triple x86_64-apple-darwin10 -include-pch %t -fsyntax-only -verify %s
+// RUN: %clang_cc1 -triple x86_64-apple-darwin10 -include-pch %t -fsyntax-only \
+// RUN:   -print-stats %s 2>&1 | FileCheck %s
+
+// CHECK: {{[1-9][0-9]*}} record layouts read
+
+int derived_size[sizeof(Derived) == DerivedSize ? 1 : -1];
+int derived_align[__alignof(Derived) == DerivedAlign ? 1 : -1];
+int wrapper_size[sizeof(Wrapper<POD>) == WrapperSize ? 1 : -1];
+int pod_size[sizeof(POD) == PODSize ? 1 : -1];
+int pod_offset_i[__builtin_offsetof(POD, i) == PODOffsetI ? 1 : -1];
+int pod_offset_d[__builtin_offsetof(POD, d) == PODOffsetD ? 1 : -1];
+int pod_offset_e[__builtin_offsetof(POD, e) == PODOffsetE ? 1 : -1];
+
+// Layouts that were not computed while building the PCH still work.
+struct MoreDerived : Derived { int m; };
+int more_derived[sizeof(MoreDerived) > sizeof(Derived) ? 1 : -1];
@@ -0,0 +1,21 @@
+// Header for PCH test cxx-record-layout.cpp
+
+struct Empty {};
+struct Base { virtual ~Base(); int b; };
+struct Other { char c; };
+struct Derived : Empty, Base, virtual Other { short s; };
+struct POD { char c; int i; double d; Empty e; };
+
+template<typename T> struct Wrapper : Derived { T t; };
+
+// Lay out the records while building the PCH, and remember the results so
+// that the layouts loaded from it can be checked against them.
+enum {
+  DerivedSize = sizeof(Derived),
+  DerivedAlign = __alignof(Derived),
+  WrapperSize = sizeof(Wrapper<POD>),
+  PODSize = sizeof(POD),
+  PODOffsetI = __builtin_offsetof(POD, i),
+  PODOffsetD = __builtin_offsetof(POD, d),
+  PODOffsetE = __builtin_offsetof(POD, e)
+};
@@ -0,0 +1,26 @@
+// Test with pch, performing the pending instantiations in the pch.
+// RUN: %clang_cc1 -x c++-header -emit-pch -fpch-instantiate-templates -o %t %S/pch-instantiate-templates.h
+// RUN: %clang_cc1 -include-pch %t %s -emit-llvm -o - | FileCheck %s
+// RUN: %clang_cc1 -include-pch %t %s -emit-llvm -o %t.ll -print-stats 2>&1 \
+// RUN:   | FileCheck -check-prefix=INST %s
+
+// Test with pch, instantiating in the translation unit.
+// RUN: %clang_cc1 -x c++-header -emit-pch -o %t.noinst %S/pch-instantiate-templates.h
+// RUN: %clang_cc1 -include-pch %t.noinst %s -emit-llvm -o - | FileCheck %s
+// RUN: %clang_cc1 -include-pch %t.noinst %s -emit-llvm -o %t.ll -print-stats 2>&1 \
+// RUN:   | FileCheck -check-prefix=NOINST %s
+
+// Instantiations from the pch are emitted when they are used here, whether
+// or not the pch already contains their definitions.
+// CHECK: define linkonce_odr i32 @_ZN3BoxIiE3getEv
+// CHECK: define linkonce_odr i32 @_Z6squareIiET_S0_
+// CHECK-NOT: @_Z6squareIdET_S0_
+
+// Only Box<int>::get and square<int> are read from the pch; square<double>
+// stays in the pch because nothing here refers to it.
+// INST: 2 implicit template instantiations read
+// NOINST: 0 implicit template instantiations read
+
+int use(Box<int> &B) {
+  return twice(B.get()) + B.get();
+}
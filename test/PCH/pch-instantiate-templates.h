@@ -0,0 +1,17 @@
+// Header for PCH test pch-instantiate-templates.cpp
+
+template<typename T> T square(T x) { return x * x; }
+
+template<typename T> struct Box {
+  T Value;
+  T get() { return square(Value); }
+};
+
+inline int twice(int x) { return 2 * x; }
+
+// Requires Box<int>::get and square<int> to be instantiated.
+inline int unbox(Box<int> &B) { return B.get(); }
+
+// Only referenced from an inline function that is never used; its
+// instantiation in the pch must not force emission.
+inline double unused() { return square(1.0); }
@@ -0,0 +1,30 @@
+// RUN: %clang_cc1 -E %s | FileCheck -strict-whitespace %s
+// Chains of single-token object-like macros are collapsed directly to their
+// final token; check that this matches C99 6.10.3.4 rescanning.
+
+#define VAL 42
+#define ALIAS1 VAL
+#define ALIAS2 ALIAS1
+a: ALIAS2 ALIAS1 VAL
+// CHECK: a: 42 42 42
+
+// The chain ends at a macro that is already being expanded.
+#define L M
+#define M N
+#define N L
+b: L M N
+// CHECK: b: L M N
+
+// A chain ending in a function-like macro uses the full expansion machinery.
+#define F G
+#define G H
+#define H(x) [x]
+c: F(1) F
+// CHECK: c: [1] H
+
+// The final token is not expanded again inside an enclosing expansion.
+#define P(x) x Q
+#define Q R
+#define R P
+d: P(Q)
+// CHECK: d: P P
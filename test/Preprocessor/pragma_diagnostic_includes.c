@@ -0,0 +1,22 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+
+// Diagnostic pragmas in an included file stay in effect in the includer
+// after the #include, and locations before the #include are unaffected.
+
+int main_before(int x) { return x == x; } // expected-warning {{self-comparison always evaluates to true}}
+
+#include "pragma_diagnostic_includes.h"
+
+int main_ignored(int x) { return x == x; }
+
+#pragma clang diagnostic pop
+
+int main_after(int x) { return x == x; } // expected-warning {{self-comparison always evaluates to true}}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wtautological-compare"
+#include "pragma_diagnostic_includes.h"
+#pragma clang diagnostic pop
+#pragma clang diagnostic pop
+
+int main_restored(int x) { return x == x; } // expected-warning {{self-comparison always evaluates to true}}
@@ -0,0 +1,4 @@
+// Leaves -Wtautological-compare ignored for the includer.
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wtautological-compare"
+int header_ignored(int x) { return x == x; }
@@ -0,0 +1,24 @@
+// RUN: %clang_cc1 -fsyntax-only -Wunused-variable -verify %s
+
+// Diagnostic pragmas issued through _Pragma within a macro expansion apply
+// to the tokens between them, even though all of those tokens share the
+// location of the expansion in the file.
+
+#define SUPPRESS_UNUSED(decl) \
+  _Pragma("clang diagnostic push") \
+  _Pragma("clang diagnostic ignored \"-Wunused-variable\"") \
+  decl \
+  _Pragma("clang diagnostic pop")
+
+#define SUPPRESS_SELF_COMPARE(expr) \
+  _Pragma("clang diagnostic push") \
+  _Pragma("clang diagnostic ignored \"-Wtautological-compare\"") \
+  expr; \
+  _Pragma("clang diagnostic pop")
+
+void f(int x) {
+  SUPPRESS_UNUSED(int a;)
+  int b; // expected-warning {{unused variable 'b'}}
+  SUPPRESS_SELF_COMPARE(x == x)
+  (void)(x == x); // expected-warning {{self-comparison always evaluates to true}}
+}
@@ -0,0 +1,35 @@
+// RUN: %clang_cc1 -fsyntax-only -Wuninitialized -print-stats %s 2>&1 | FileCheck %s
+
+// No CFG is built for functions none of the analyses can report anything
+// about.
+int ends_in_return(int x) {
+  if (x)
+    return 1;
+  return x + 1;
+}
+
+void empty(void) {}
+
+void no_locals(int *p) {
+  if (p)
+    *p = 0;
+}
+
+// These need one: falling off the end has to be ruled out, and a local has
+// to be checked for uninitialized uses.
+int ends_in_if(int x) {
+  if (x)
+    return 1;
+  else
+    return 0;
+}
+
+void has_local(void) {
+  int y;
+  y = 1;
+  (void)y;
+}
+
+// CHECK: *** Analysis Based Warnings Stats:
+// CHECK-NEXT: 2 functions analyzed (0 w/o CFGs).
+// CHECK-NEXT: 3 functions needed no CFG.
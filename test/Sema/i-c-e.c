@@ -1,4 +1,5 @@
 // RUN: %clang %s -ffreestanding -fsyntax-only -Xclang -verify -pedantic -fpascal-strings -std=c99
+// RUN: %clang %s -ffreestanding -fsyntax-only -Xclang -verify -pedantic -fpascal-strings -std=c99 -Xclang -fconstant-evaluator=check
 
 #include <stdint.h>
 #include <limits.h>
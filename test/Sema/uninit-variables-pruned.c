@@ -0,0 +1,39 @@
+// RUN: %clang_cc1 -fsyntax-only -Wuninitialized -Wconditional-uninitialized \
+// RUN:   -fblocks %s -verify
+// RUN: %clang_cc1 -fsyntax-only -Wuninitialized -Wconditional-uninitialized \
+// RUN:   -fblocks -print-stats %s 2>&1 | FileCheck %s
+
+// Variables that are never referenced, or that are initialized by their
+// declaration before every use, are left out of the analysis.
+int pruned(int n) {
+  int a = n, b = a + 1;
+  int unused;
+  int x; // expected-note{{initialize the variable 'x' to silence this warning}}
+  if (n)
+    x = b;
+  return x; // expected-warning{{variable 'x' may be uninitialized when used here}}
+}
+
+// A jump past the declaration keeps an initialized variable in.
+int jump(int n) {
+  if (n)
+    goto use;
+  int y = n; // expected-note{{variable 'y' is declared here}}
+use:
+  return y; // expected-warning{{variable 'y' may be uninitialized when used here}}
+}
+
+// So does an initializer referring to the variable itself.
+int self(void) {
+  int z = z; // expected-warning{{variable 'z' is uninitialized when used within its own initialization}}
+  return z;
+}
+
+// A variable only used in a block is referenced through the capture.
+void captured(void) {
+  int c; // expected-note{{initialize the variable 'c' to silence this warning}}
+  ^{ (void)c; }(); // expected-warning{{variable 'c' is uninitialized when captured by block}}
+}
+
+// CHECK: 4 variables analyzed.
+// CHECK-NEXT: 3 variables pruned without analysis.
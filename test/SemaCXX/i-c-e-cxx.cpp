@@ -1,4 +1,5 @@
 // RUN: %clang_cc1 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -fsyntax-only -verify -fconstant-evaluator=check %s
 
 // C++-specific tests for integral constant expressions.
 
@@ -0,0 +1,46 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+
+// Redeclarations of functions with more overloads than a lookup table
+// keeps without an index.
+
+template<int N> struct T { };
+
+#define DECL(n) int f(T<n>);
+#define DECL4(n) DECL(n##1) DECL(n##2) DECL(n##3) DECL(n##4)
+#define DECL16(n) DECL4(n##1) DECL4(n##2) DECL4(n##3) DECL4(n##4)
+
+namespace M {
+  int f(double);
+}
+
+namespace N {
+  DECL16(1) DECL16(2)
+  DECL16(1) DECL16(2)
+
+  int f(T<111>) { return 1; } // expected-note {{previous definition is here}}
+  int f(T<111>) { return 2; } // expected-error {{redefinition of 'f'}}
+
+  // A tag and a using declaration move declarations around in the list.
+  struct f { };
+  using M::f;
+
+  DECL16(2)
+  int f(T<244>) { return 3; }
+}
+
+int g() {
+  return N::f(T<111>()) + N::f(T<244>()) + N::f(T<123>()) + N::f(1.0);
+}
+
+struct S {
+  DECL16(1) DECL16(2)
+  int f(int);
+};
+
+int S::f(T<144>) { return 4; } // expected-note {{previous definition is here}}
+int S::f(T<144>) { return 5; } // expected-error {{redefinition of 'f'}}
+int S::f(int) { return 6; }
+
+int h(S &s) {
+  return s.f(T<144>()) + s.f(0);
+}
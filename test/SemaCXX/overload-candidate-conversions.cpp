@@ -0,0 +1,32 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+
+// Candidates whose parameters can't be initialized from a pointer, array or
+// function argument are rejected early; make sure the diagnostics are
+// unchanged and that conversions shared between candidates are still right.
+struct Stream {
+  Stream &operator<<(int);
+  Stream &operator<<(double);
+  Stream &operator<<(const char *);
+};
+
+struct Wrapper { Wrapper(int); };
+Stream &operator<<(Stream &, Wrapper);
+Stream &operator<<(Stream &, long);
+Stream &operator<<(Stream &, bool);
+
+void f();
+
+void test(Stream &S, const char *Str, int *IP) {
+  S << "string" << Str << 1 << 2.0 << Wrapper(3) << 4L;
+  S << IP; // converts to bool
+  S << &f; // converts to bool
+}
+
+struct NoBool {
+  NoBool &operator<<(int); // expected-note {{candidate function not viable: no known conversion from 'void ()' to 'int' for 1st argument}}
+  NoBool &operator<<(double); // expected-note {{candidate function not viable: no known conversion from 'void ()' to 'double' for 1st argument}}
+};
+
+void test_nobool(NoBool &N) {
+  N << f; // expected-error {{invalid operands to binary expression ('NoBool' and 'void ()')}}
+}
@@ -0,0 +1,61 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+
+// Redeclarations of overloaded functions and function templates replace the
+// previous declaration on the identifier chain.
+namespace N {
+  struct A {}; struct B {}; struct C {};
+
+  void f(A);
+  void f(B);
+  template<typename T> T *f(T *, C);
+
+  void f(A) {}
+  void f(B) {}
+  template<typename T> T *f(T *p, C) { return p; }
+
+  void g() {
+    f(A());
+    f(B());
+    int *p = f((int *)0, C());
+  }
+}
+
+// Block-scope redeclarations of a function that was declared in an
+// enclosing scope.
+void h(int);
+void test_local() {
+  void h(int);
+  {
+    void h(int);
+    void h(int);
+    h(0);
+  }
+  h(1);
+}
+
+// Long identifier chains remove redeclared entries through an index; the
+// remaining overloads must stay visible as entries are removed and the
+// chain is compacted.
+namespace Many {
+  template<int> struct T {};
+
+#define DECL(n) void m(T<n>);
+#define DEFN(n) void m(T<n>) {}
+#define USE(n) m(T<n>());
+#define X4(M, n) M(n##0) M(n##1) M(n##2) M(n##3)
+#define X16(M) X4(M, 1) X4(M, 2) X4(M, 3) X4(M, 4)
+
+  X16(DECL)
+  X16(DEFN)
+  X16(DECL)
+
+  void use() {
+    X16(USE)
+  }
+
+#undef X16
+#undef X4
+#undef USE
+#undef DEFN
+#undef DECL
+}
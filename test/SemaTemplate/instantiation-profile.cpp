@@ -0,0 +1,41 @@
+// RUN: %clang_cc1 -fsyntax-only -ftemplate-instantiation-profile %s \
+// RUN:   > %t.profile 2>&1
+// RUN: FileCheck %s < %t.profile
+// RUN: FileCheck -check-prefix=FIB5 %s < %t.profile
+// RUN: FileCheck -check-prefix=FIB2 %s < %t.profile
+// RUN: FileCheck -check-prefix=DEDUCE %s < %t.profile
+// RUN: FileCheck -check-prefix=IDENTITY %s < %t.profile
+// RUN: %clang_cc1 -fsyntax-only -ftemplate-instantiation-trace %t.json %s
+// RUN: FileCheck -check-prefix=TRACE %s < %t.json
+
+namespace N {
+  template<int I> struct Fib {
+    static const int value = Fib<I-1>::value + Fib<I-2>::value;
+  };
+  template<> struct Fib<1> { static const int value = 1; };
+  template<> struct Fib<0> { static const int value = 0; };
+}
+
+template<typename T> T identity(T t) { return t; }
+
+int f() { return identity(N::Fib<5>::value); }
+
+// The profile is ordered by cost, so each entry is checked on its own.
+// CHECK: *** Template Instantiation Profile:
+// CHECK:   Wall Time     Bytes   Count  Nested  Name
+// CHECK-NOT: N::Fib<1>
+
+// Count and nested instantiations precede each name.
+// FIB5: {{ +}}1{{ +}}3  N::Fib<5>
+// FIB2: {{ +}}1{{ +}}0  N::Fib<2>
+// DEDUCE: deduced template argument substitution into identity
+// IDENTITY: {{ +}}1{{ +}}0  identity<int>
+
+// Trace events are written as instantiations finish, innermost first.
+// TRACE: { "traceEvents": [
+// TRACE: { "name": "N::Fib<2>", "cat": "template", "ph": "X"
+// TRACE: { "name": "N::Fib<3>", "cat": "template", "ph": "X"
+// TRACE: { "name": "N::Fib<4>", "cat": "template", "ph": "X"
+// TRACE: { "name": "N::Fib<5>", "cat": "template", "ph": "X"
+// TRACE: { "name": "identity<int>", "cat": "template", "ph": "X"
+// TRACE: ] }
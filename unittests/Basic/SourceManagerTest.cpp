@@ -0,0 +1,78 @@
+//===- unittests/Basic/SourceManagerTest.cpp ------ SourceManager tests ---===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/SourceManager.h"
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/FileSystemOptions.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace clang;
+
+namespace {
+
+// The test fixture.
+class SourceManagerTest : public ::testing::Test {
+protected:
+  SourceManagerTest()
+    : FileMgr(FileMgrOpts),
+      DiagID(new DiagnosticIDs()),
+      Diags(DiagID, new IgnoringDiagConsumer()),
+      SourceMgr(Diags, FileMgr) {
+  }
+
+  FileSystemOptions FileMgrOpts;
+  FileManager FileMgr;
+  IntrusiveRefCntPtr<DiagnosticIDs> DiagID;
+  DiagnosticsEngine Diags;
+  SourceManager SourceMgr;
+};
+
+// Build two deep chains of nested macro expansions, expanded at different
+// offsets of the main file, with interleaved FileIDs.
+TEST_F(SourceManagerTest, isBeforeInTranslationUnitNestedExpansions) {
+  const char *Source = "0123456789abcdef";
+  MemoryBuffer *Buf = MemoryBuffer::getMemBuffer(Source);
+  FileID MainFID = SourceMgr.createMainFileIDForMemBuffer(Buf);
+  SourceLocation Main = SourceMgr.getLocForStartOfFile(MainFID);
+
+  const unsigned Depth = 40;
+  SourceLocation A[Depth], B[Depth];
+  SourceLocation AParent = Main.getLocWithOffset(5);
+  SourceLocation BParent = Main.getLocWithOffset(10);
+  for (unsigned I = 0; I != Depth; ++I) {
+    A[I] = SourceMgr.createExpansionLoc(Main, AParent, AParent, 1);
+    B[I] = SourceMgr.createExpansionLoc(Main, BParent, BParent, 1);
+    AParent = A[I];
+    BParent = B[I];
+  }
+
+  for (unsigned I = 0; I != Depth; ++I) {
+    for (unsigned J = 0; J != Depth; ++J) {
+      EXPECT_TRUE(SourceMgr.isBeforeInTranslationUnit(A[I], B[J]));
+      EXPECT_FALSE(SourceMgr.isBeforeInTranslationUnit(B[J], A[I]));
+      // An expansion comes before the expansions nested in it.
+      EXPECT_EQ(I < J, SourceMgr.isBeforeInTranslationUnit(A[I], A[J]));
+    }
+
+    EXPECT_TRUE(SourceMgr.isBeforeInTranslationUnit(Main.getLocWithOffset(3),
+                                                    A[I]));
+    EXPECT_TRUE(SourceMgr.isBeforeInTranslationUnit(Main.getLocWithOffset(5),
+                                                    A[I]));
+    EXPECT_TRUE(SourceMgr.isBeforeInTranslationUnit(A[I],
+                                                    Main.getLocWithOffset(7)));
+    EXPECT_FALSE(SourceMgr.isBeforeInTranslationUnit(B[I],
+                                                     Main.getLocWithOffset(7)));
+  }
+}
+
+} // anonymous namespace